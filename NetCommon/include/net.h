@@ -1,7 +1,11 @@
 #pragma once
 
 #include "net_common.h"
+#include "net_queue.h"
+#include "net_packet.h"
+#include "net_socket.h"
 #include "net_client.h"
 #include "net_server.h"
 #include "net_message.h"
+#include "net_channel.h"
 
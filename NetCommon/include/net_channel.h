@@ -0,0 +1,444 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <optional>
+
+#include "net_message.h"
+
+namespace net
+{
+    /**
+     * @brief The largest reliable message (e.g. an EventMessage).
+     *
+     */
+    constexpr std::size_t K_MAX_RELIABLE_SIZE = 64;
+    /**
+     * @brief The bytes the datagrams filled by the sender (e.g.
+     * the snapshot parts, see encode_snapshot()) leave for the
+     * trailer of reliable messages: its count and two messages
+     * of the largest size, or more smaller ones.
+     *
+     */
+    constexpr std::size_t K_RELIABLE_BUDGET = 1 + 2 * (4 + K_MAX_RELIABLE_SIZE);
+    /**
+     * @brief The maximum number of reliable messages waiting to
+     * be acknowledged, or to be delivered in order.
+     *
+     */
+    constexpr std::size_t K_MAX_PENDING_RELIABLE = 256;
+    /**
+     * @brief The delay after which a reliable message whose
+     * datagram wasn't acknowledged is sent again.
+     *
+     */
+    constexpr std::chrono::milliseconds K_RESEND_DELAY(100);
+    /**
+     * @brief The number of sequences acknowledged before the
+     * last one, by MessageHeader::ack_bits.
+     *
+     */
+    constexpr std::uint16_t K_ACK_WINDOW = 32;
+
+    /**
+     * @brief What to do with a received datagram, according to
+     * its sequence.
+     *
+     */
+    enum receiveStatus {
+        /**
+         * @brief The newest datagram so far, its payload is used.
+         *
+         */
+        RECEIVE_NEW,
+        /**
+         * @brief Older than a datagram already received, its
+         * unreliable payload is outdated and dropped (its reliable
+         * messages were still delivered).
+         *
+         */
+        RECEIVE_STALE,
+        /**
+         * @brief Already received, or not a valid datagram.
+         *
+         */
+        RECEIVE_DROPPED,
+    };
+
+    /**
+     * @brief Indicate if a sequence number comes after another,
+     * the numbers wrapping around.
+     *
+     */
+    inline bool sequence_newer(std::uint16_t sequence, std::uint16_t than)
+    {
+        return static_cast<std::int16_t>(sequence - than) > 0;
+    }
+
+    /**
+     * @brief The channels between two peers over a UDP socket:
+     * - unreliable-sequenced: every datagram is numbered and the
+     *   ones older than the last received are reported stale, so
+     *   an outdated snapshot or input is never used;
+     * - reliable-ordered: spawn, despawn and game events are queued
+     *   with send_reliable() and carried in the trailer of the next
+     *   datagrams (typically the snapshots), until the datagram
+     *   carrying them is acknowledged. Only the messages whose
+     *   datagram was lost are sent again, and they are delivered
+     *   in order on the other side.
+     *
+     * Every datagram acknowledges the last sequence received and
+     * the 32 before it (MessageHeader::ack and ack_bits), so acks
+     * don't need datagrams of their own and a lost ack is covered
+     * by the next ones. The reliable messages that didn't fit in
+     * the datagrams sent, or are due while nothing is sent, go
+     * in MESSAGE_ACK datagrams of their own with flush().
+     * A connection is used by a single thread.
+     *
+     * e.g:
+     * ```cpp
+     * connection.send_reliable(MESSAGE_SPAWN, SpawnMessage{...});
+     * encode_snapshot(snapshot, baseline, input_tick, header, acquire, [&](Packet *packet)
+     * {
+     *     connection.stamp(*packet);
+     *     server.send_packet(packet, endpoint);
+     * });
+     * connection.flush(acquire, [&](Packet *packet) { server.send_packet(packet, endpoint); });
+     * ```
+     *
+     */
+    class Connection
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        Connection()
+            : local_sequence_(0),
+              // until a datagram is received, acknowledge a sequence the peer won't send soon
+              remote_sequence_(0xffff),
+              received_bits_(0),
+              received_any_(false),
+              latest_ack_bits_(0),
+              next_reliable_id_(0),
+              next_delivered_id_(0)
+        {
+        }
+
+        /**
+         * @brief Get the header of the next datagram, its
+         * sequence and acks being set by stamp().
+         *
+         */
+        MessageHeader make_header(messageType type) const
+        {
+            return MessageHeader{PROTOCOL_VERSION, type, 0, 0, 0, 0};
+        }
+
+        /**
+         * @brief Queue a reliable message.
+         *
+         * @return false The message is too big, or too many
+         * messages are waiting to be acknowledged.
+         */
+        template <typename Message>
+        bool send_reliable(messageType type, const Message &message)
+        {
+            if (pending_.size() >= K_MAX_PENDING_RELIABLE) {
+                return false;
+            }
+            Packet scratch;
+            MessageWriter writer(scratch, 0);
+
+            message.write(writer);
+            if (!writer.ok() || writer.size() > K_MAX_RELIABLE_SIZE) {
+                return false;
+            }
+            Pending pending{next_reliable_id_++, type, static_cast<std::uint8_t>(writer.size()), {}, false, 0, {}};
+
+            std::memcpy(pending.data, scratch.data.data(), writer.size());
+            pending_.push_back(pending);
+            return true;
+        }
+
+        /**
+         * @brief Indicate if reliable messages are due, to send a
+         * MESSAGE_ACK datagram if nothing else is sent.
+         *
+         */
+        bool has_reliable_due(clock::time_point now = clock::now()) const
+        {
+            for (const Pending &pending : pending_) {
+                if (due(pending, now)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Number a finished datagram, acknowledge the
+         * received ones and append the reliable messages due,
+         * as many as fit.
+         *
+         */
+        void stamp(Packet &packet, clock::time_point now = clock::now())
+        {
+            std::uint16_t sequence = local_sequence_++;
+            MessageWriter header(packet, 2);
+
+            header.write(sequence);
+            header.write(remote_sequence_);
+            header.write(received_bits_);
+
+            MessageWriter trailer(packet, packet.size);
+            std::size_t count_offset = packet.size;
+            std::uint8_t count = 0;
+
+            trailer.write(count);
+            for (Pending &pending : pending_) {
+                if (count == 0xff || trailer.size() + 4 + pending.size > K_BUFFER_SIZE) {
+                    break;
+                }
+                if (!due(pending, now)) {
+                    continue;
+                }
+                trailer.write(pending.id);
+                trailer.write(pending.type);
+                trailer.write(pending.size);
+                trailer.write_bytes(pending.data, pending.size);
+                pending.sent = true;
+                pending.carrier = sequence;
+                pending.sent_at = now;
+                ++count;
+            }
+            if (count > 0 && trailer.ok()) {
+                packet.data[count_offset] = static_cast<char>(count);
+                packet.size = trailer.size();
+            }
+        }
+
+        /**
+         * @brief Send the reliable messages still due once the
+         * datagrams of a tick are stamped, in MESSAGE_ACK datagrams
+         * of their own, so they don't starve behind full datagrams.
+         *
+         * @param acquire Returns a pooled packet, or nullptr.
+         * @param send Sends a stamped packet.
+         * @return std::size_t The number of datagrams sent.
+         */
+        template <typename Acquire, typename Send>
+        std::size_t flush(Acquire &&acquire, Send &&send, clock::time_point now = clock::now())
+        {
+            std::size_t count = 0;
+
+            while (has_reliable_due(now)) {
+                Packet *packet = acquire();
+
+                if (!packet) {
+                    break;
+                }
+                MessageWriter writer(*packet);
+
+                writer.finish(make_header(MESSAGE_ACK));
+                stamp(*packet, now);
+                send(packet);
+                ++count;
+            }
+            return count;
+        }
+
+        /**
+         * @brief Handle the sequence, acks and reliable messages
+         * of a received datagram.
+         *
+         * @param packet The datagram.
+         * @param handler Called with a MessageReader on each newly
+         * delivered reliable message, in the order they were sent.
+         * @return receiveStatus Whether the payload is to be used.
+         */
+        template <typename Handler>
+        receiveStatus receive(const Packet &packet, Handler &&handler)
+        {
+            MessageReader reader(packet);
+
+            if (!reader.ok()) {
+                return RECEIVE_DROPPED;
+            }
+            receiveStatus status = track(reader.header().sequence);
+
+            if (status == RECEIVE_DROPPED) {
+                return status;
+            }
+            acknowledge(reader.header().ack, reader.header().ack_bits);
+            if (reader.trailer()) {
+                read_reliable(reader, handler);
+            }
+            return status;
+        }
+
+        /**
+         * @brief Get the number of reliable messages waiting to
+         * be acknowledged.
+         *
+         */
+        std::size_t get_pending_count() const
+        {
+            return pending_.size();
+        }
+
+    private:
+        struct Pending
+        {
+            std::uint16_t id;
+            std::uint8_t type;
+            std::uint8_t size;
+            char data[K_MAX_RELIABLE_SIZE];
+            bool sent;
+            /**
+             * @brief The sequence of the last datagram carrying
+             * the message.
+             *
+             */
+            std::uint16_t carrier;
+            clock::time_point sent_at;
+        };
+
+        /**
+         * @brief Indicate if a sequence is acknowledged by a
+         * received header.
+         *
+         */
+        static bool acked(std::uint16_t sequence, std::uint16_t ack, std::uint32_t ack_bits)
+        {
+            std::uint16_t distance = ack - sequence;
+
+            return distance == 0 || (distance <= K_ACK_WINDOW && (ack_bits & (std::uint32_t(1) << (distance - 1))));
+        }
+
+        bool due(const Pending &pending, clock::time_point now) const
+        {
+            if (!pending.sent || now - pending.sent_at >= K_RESEND_DELAY) {
+                return true;
+            }
+            // a newer datagram was acknowledged but not the carrier: it is lost
+            return latest_ack_ && sequence_newer(*latest_ack_, pending.carrier)
+                && static_cast<std::uint16_t>(*latest_ack_ - pending.carrier) <= K_ACK_WINDOW
+                && !acked(pending.carrier, *latest_ack_, latest_ack_bits_);
+        }
+
+        receiveStatus track(std::uint16_t sequence)
+        {
+            if (!received_any_ || sequence_newer(sequence, remote_sequence_)) {
+                std::uint16_t shift = received_any_ ? sequence - remote_sequence_ : K_ACK_WINDOW + 1;
+
+                received_bits_ = (shift > K_ACK_WINDOW) ? 0 : (received_bits_ << shift);
+                if (received_any_ && shift <= K_ACK_WINDOW) {
+                    received_bits_ |= std::uint32_t(1) << (shift - 1);
+                }
+                remote_sequence_ = sequence;
+                received_any_ = true;
+                return RECEIVE_NEW;
+            }
+            std::uint16_t distance = remote_sequence_ - sequence;
+
+            if (distance == 0) {
+                return RECEIVE_DROPPED;
+            }
+            if (distance <= K_ACK_WINDOW) {
+                std::uint32_t bit = std::uint32_t(1) << (distance - 1);
+
+                if (received_bits_ & bit) {
+                    return RECEIVE_DROPPED;
+                }
+                received_bits_ |= bit;
+            }
+            // too old to be told apart from a duplicate, the reliable ids are
+            return RECEIVE_STALE;
+        }
+
+        void acknowledge(std::uint16_t ack, std::uint32_t ack_bits)
+        {
+            if (latest_ack_ && !sequence_newer(ack, *latest_ack_)) {
+                if (ack == *latest_ack_) {
+                    latest_ack_bits_ |= ack_bits;
+                }
+            } else {
+                latest_ack_ = ack;
+                latest_ack_bits_ = ack_bits;
+            }
+            for (auto it = pending_.begin(); it != pending_.end();) {
+                if (it->sent && acked(it->carrier, ack, ack_bits)) {
+                    it = pending_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        template <typename Handler>
+        void read_reliable(MessageReader &reader, Handler &handler)
+        {
+            std::uint8_t count = 0;
+
+            reader.read(count);
+            for (std::uint8_t i = 0; i < count; i++) {
+                Packet message;
+                std::uint16_t id = 0;
+                std::uint8_t type = 0;
+                std::uint8_t size = 0;
+
+                reader.read(id);
+                reader.read(type);
+                if (!reader.read(size) || size > K_MAX_RELIABLE_SIZE || !reader.read_bytes(message.data.data() + K_HEADER_SIZE, size)) {
+                    return;
+                }
+                std::uint16_t distance = id - next_delivered_id_;
+
+                // already delivered, or too far ahead to be buffered
+                if (distance >= K_MAX_PENDING_RELIABLE || received_.count(id)) {
+                    continue;
+                }
+                MessageWriter writer(message, K_HEADER_SIZE + size);
+
+                writer.finish(MessageHeader{PROTOCOL_VERSION, type, 0, 0, 0, 0});
+                received_.emplace(id, message);
+            }
+            for (auto it = received_.find(next_delivered_id_); it != received_.end(); it = received_.find(next_delivered_id_)) {
+                MessageReader message(it->second);
+
+                handler(message);
+                received_.erase(it);
+                ++next_delivered_id_;
+            }
+        }
+
+        std::uint16_t local_sequence_;
+        std::uint16_t remote_sequence_;
+        /**
+         * @brief The sequences received among the 32 before
+         * remote_sequence_.
+         *
+         */
+        std::uint32_t received_bits_;
+        bool received_any_;
+        /**
+         * @brief The newest ack received, and its bits, to detect
+         * the lost datagrams.
+         *
+         */
+        std::optional<std::uint16_t> latest_ack_;
+        std::uint32_t latest_ack_bits_;
+        std::uint16_t next_reliable_id_;
+        std::uint16_t next_delivered_id_;
+        std::deque<Pending> pending_;
+        /**
+         * @brief The reliable messages received ahead of the next
+         * one to be delivered, as standalone messages.
+         *
+         */
+        std::map<std::uint16_t, Packet> received_;
+    };
+}
@@ -1,91 +1,92 @@
 #pragma once
 
+#include <limits>
+
 #include "net_common.h"
 #include "net_message.h"
+#include "net_socket.h"
 
 using namespace boost::asio;
 using boost::asio::ip::udp;
 using namespace net;
 
-constexpr int K_BUFFER_SIZE = 1024;
-
 namespace net
 {
+    constexpr std::size_t K_CLIENT_QUEUE_SIZE = 256;
+
+    /**
+     * @brief A UDP client of a single server. Like UdpServer,
+     * the received datagrams are drained with poll() (see
+     * PacketSocket).
+     *
+     */
     class UdpClient
     {
     public:
-        UdpClient(io_context &io_context, udp::endpoint server_endpoint)
-            : socket_(io_context),
-              server_endpoint_(server_endpoint),
-              stop_flag_(false)
+        UdpClient(io_context &io_context, udp::endpoint server_endpoint, std::size_t queue_size = K_CLIENT_QUEUE_SIZE)
+            : socket_(io_context, udp::v4(), queue_size),
+              server_endpoint_(server_endpoint)
         {
-            socket_.open(udp::v4());
-            start_receive();
         }
 
-        ~UdpClient()
+        void stop()
         {
-            stop();
+            socket_.stop();
         }
 
-        void stop()
+        /**
+         * @brief Send a datagram to the server, see
+         * PacketSocket::send().
+         *
+         */
+        void send(const void *data, std::size_t size)
         {
-            if (!stop_flag_) {
-                stop_flag_ = true;
-                socket_.close();
-            }
+            socket_.send(data, size, server_endpoint_);
         }
 
-        void send_data(const DataPacket &data)
+        /**
+         * @brief Take a packet to write a message into, see
+         * PacketSocket::acquire_packet().
+         *
+         */
+        Packet *acquire_packet()
         {
+            return socket_.acquire_packet();
+        }
 
-            if (socket_.is_open()) {
-                // The socket is open and the file descriptor is valid.
-                std::cout << "Sending data to " << server_endpoint_ << std::endl;
-                std::cout << "{" << data.id << ", " << data.value << "}" << std::endl;
-            }
-            // std::cout << socket_ << std::endl;
-            socket_.async_send_to(
-                buffer(&data, sizeof(data)), server_endpoint_,
-                [](boost::system::error_code ec, std::size_t /*bytes_sent*/)
-                {
-                    std::cout << "Data sent" << std::endl;
-                    if (ec) {
-                        std::cerr << "Error: " << ec.message() << std::endl;
-                    }
-                });
+        void release_packet(Packet *packet)
+        {
+            socket_.release_packet(packet);
         }
 
-    private:
-        void start_receive()
+        /**
+         * @brief Send a packet taken with acquire_packet(), see
+         * PacketSocket::send_packet().
+         *
+         */
+        void send_packet(Packet *packet)
         {
-            socket_.async_receive_from(
-                buffer(data_), sender_endpoint_,
-                [this](boost::system::error_code ec, std::size_t bytes_received)
-                {
-                    if (!ec && bytes_received == sizeof(DataPacket)) {
-                        std::thread([this]()
-                                    { process_data(); })
-                            .detach();
-                    }
+            socket_.send_packet(packet, server_endpoint_);
+        }
 
-                    if (!stop_flag_) {
-                        start_receive();
-                    }
-                });
+        /**
+         * @brief Handle the received datagrams, see
+         * PacketSocket::poll().
+         *
+         */
+        template <typename Handler>
+        std::size_t poll(Handler &&handler, std::size_t max = std::numeric_limits<std::size_t>::max())
+        {
+            return socket_.poll(std::forward<Handler>(handler), max);
         }
 
-        void process_data()
+        SocketStats get_stats() const
         {
-            DataPacket *data = reinterpret_cast<DataPacket *>(data_.data());
-            std::cout << "Received data from " << sender_endpoint_ << ": id=" << data->id
-                      << ", value=" << data->value << std::endl;
+            return socket_.get_stats();
         }
 
-        udp::socket socket_;
-        udp::endpoint sender_endpoint_;
+    private:
+        PacketSocket socket_;
         udp::endpoint server_endpoint_;
-        std::array<char, sizeof(DataPacket)> data_;
-        bool stop_flag_;
     };
-}
\ No newline at end of file
+}
@@ -1,8 +1,778 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "net_packet.h"
+
 namespace net
 {
-    struct DataPacket
+    /**
+     * @brief The version of the wire protocol. A peer drops
+     * the messages of another version.
+     *
+     */
+    constexpr std::uint8_t PROTOCOL_VERSION = 3;
+    /**
+     * @brief The size of MessageHeader on the wire.
+     *
+     */
+    constexpr std::size_t K_HEADER_SIZE = 12;
+    /**
+     * @brief The baseline of a snapshot sent in full.
+     *
+     */
+    constexpr std::uint32_t K_NO_BASELINE = 0xffffffff;
+    /**
+     * @brief The input tick of a snapshot sent before any input
+     * of the client was applied.
+     *
+     */
+    constexpr std::uint32_t K_NO_INPUT = 0xffffffff;
+
+    /**
+     * @brief The unsigned integer of the same size as a number
+     * (or enum), used to write it byte by byte.
+     *
+     */
+    template <typename T>
+    using wire_type = std::make_unsigned_t<typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>, std::common_type<T>>::type>;
+
+    /**
+     * @brief The type of a message, given by its header.
+     *
+     */
+    enum messageType : std::uint8_t {
+        MESSAGE_INPUT = 1,
+        MESSAGE_SNAPSHOT,
+        MESSAGE_SPAWN,
+        MESSAGE_DESPAWN,
+        MESSAGE_EVENT,
+        MESSAGE_SNAPSHOT_ACK,
+        /**
+         * @brief A datagram without payload, sent to acknowledge
+         * the received ones or to carry reliable messages when
+         * nothing else is sent.
+         *
+         */
+        MESSAGE_ACK,
+        /**
+         * @brief A JoinMessage, sent by a client until its player
+         * is spawned.
+         *
+         */
+        MESSAGE_JOIN,
+    };
+
+    /**
+     * @brief The header starting every datagram. The sequence
+     * numbers the datagrams sent by a peer, and ack/ack_bits
+     * acknowledge the last sequence received from the other
+     * peer and the 32 before it.
+     *
+     */
+    struct MessageHeader
+    {
+        std::uint8_t version;
+        std::uint8_t type;
+        std::uint16_t sequence;
+        std::uint16_t ack;
+        std::uint32_t ack_bits;
+        std::uint16_t payload_size;
+    };
+
+    /**
+     * @brief Writes a message directly into a pooled packet,
+     * little-endian whatever the host is. The header is written
+     * by finish(), once the payload size is known. Writing past
+     * the packet makes the writer fail instead of overflowing.
+     *
+     * e.g:
+     * ```cpp
+     * Packet *packet = server.acquire_packet();
+     * MessageWriter writer(*packet);
+     *
+     * DespawnMessage{entity}.write(writer);
+     * if (writer.finish(MessageHeader{PROTOCOL_VERSION, MESSAGE_DESPAWN, sequence, ack, ack_bits, 0}))
+     *     server.send_packet(packet, endpoint);
+     * ```
+     *
+     */
+    class MessageWriter
+    {
+    public:
+        explicit MessageWriter(Packet &packet)
+            : packet_(packet),
+              offset_(K_HEADER_SIZE),
+              ok_(true)
+        {
+        }
+
+        /**
+         * @brief Write from an offset of the packet, e.g. to
+         * patch a finished message.
+         *
+         */
+        MessageWriter(Packet &packet, std::size_t offset)
+            : packet_(packet),
+              offset_(offset),
+              ok_(true)
+        {
+        }
+
+        template <typename T>
+        void write(T value)
+        {
+            static_assert((std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) || std::is_enum_v<T>, "only numbers are written");
+            if constexpr (std::is_floating_point_v<T>) {
+                static_assert(sizeof(T) == sizeof(std::uint32_t), "only 32 bits floats are written");
+                std::uint32_t bits;
+
+                std::memcpy(&bits, &value, sizeof(bits));
+                write(bits);
+            } else {
+                if (!reserve(sizeof(T))) {
+                    return;
+                }
+                auto bits = static_cast<wire_type<T>>(value);
+
+                for (std::size_t i = 0; i < sizeof(T); i++) {
+                    packet_.data[offset_++] = static_cast<char>((bits >> (8 * i)) & 0xff);
+                }
+            }
+        }
+
+        void write_bytes(const void *data, std::size_t size)
+        {
+            if (!reserve(size)) {
+                return;
+            }
+            std::memcpy(packet_.data.data() + offset_, data, size);
+            offset_ += size;
+        }
+
+        /**
+         * @brief Write the header in front of the payload and set
+         * the size of the packet.
+         *
+         * @param header The header, its payload size is ignored.
+         * @return false The payload didn't fit in the packet.
+         */
+        bool finish(MessageHeader header)
+        {
+            if (!ok_) {
+                return false;
+            }
+            std::size_t end = offset_;
+
+            header.payload_size = static_cast<std::uint16_t>(end - K_HEADER_SIZE);
+            offset_ = 0;
+            write(header.version);
+            write(header.type);
+            write(header.sequence);
+            write(header.ack);
+            write(header.ack_bits);
+            write(header.payload_size);
+            offset_ = end;
+            packet_.size = end;
+            return true;
+        }
+
+        bool ok() const
+        {
+            return ok_;
+        }
+
+        std::size_t size() const
+        {
+            return offset_;
+        }
+
+    private:
+        bool reserve(std::size_t size)
+        {
+            if (ok_ && offset_ + size > packet_.data.size()) {
+                ok_ = false;
+            }
+            return ok_;
+        }
+
+        Packet &packet_;
+        std::size_t offset_;
+        bool ok_;
+    };
+
+    /**
+     * @brief Reads a message from a received packet. The header
+     * is read and checked first, then the payload is read in the
+     * order it was written. Reading past the payload makes the
+     * reader fail, every later read failing as well, so the
+     * result only needs to be checked once at the end.
+     * The bytes following the payload, if any, are the trailer
+     * (see Connection), read after a call to trailer().
+     *
+     */
+    class MessageReader
+    {
+    public:
+        MessageReader(const char *data, std::size_t size)
+            : data_(data),
+              size_(size),
+              end_(size),
+              offset_(0),
+              ok_(true),
+              header_()
+        {
+            read(header_.version);
+            read(header_.type);
+            read(header_.sequence);
+            read(header_.ack);
+            read(header_.ack_bits);
+            read(header_.payload_size);
+            if (header_.version != PROTOCOL_VERSION || K_HEADER_SIZE + header_.payload_size > size_) {
+                ok_ = false;
+            }
+            end_ = K_HEADER_SIZE + header_.payload_size;
+        }
+
+        explicit MessageReader(const Packet &packet)
+            : MessageReader(packet.data.data(), packet.size)
+        {
+        }
+
+        const MessageHeader &header() const
+        {
+            return header_;
+        }
+
+        template <typename T>
+        bool read(T &value)
+        {
+            static_assert((std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) || std::is_enum_v<T>, "only numbers are read");
+            if constexpr (std::is_floating_point_v<T>) {
+                static_assert(sizeof(T) == sizeof(std::uint32_t), "only 32 bits floats are read");
+                std::uint32_t bits = 0;
+
+                if (read(bits)) {
+                    std::memcpy(&value, &bits, sizeof(value));
+                }
+            } else {
+                if (!consume(sizeof(T))) {
+                    return false;
+                }
+                wire_type<T> bits = 0;
+
+                for (std::size_t i = 0; i < sizeof(T); i++) {
+                    bits |= static_cast<decltype(bits)>(static_cast<std::uint8_t>(data_[offset_++])) << (8 * i);
+                }
+                value = static_cast<T>(bits);
+            }
+            return ok_;
+        }
+
+        bool read_bytes(void *data, std::size_t size)
+        {
+            if (!consume(size)) {
+                return false;
+            }
+            std::memcpy(data, data_ + offset_, size);
+            offset_ += size;
+            return true;
+        }
+
+        bool ok() const
+        {
+            return ok_;
+        }
+
+        /**
+         * @brief Indicate if the whole payload (or trailer) was read.
+         *
+         */
+        bool done() const
+        {
+            return ok_ && offset_ == end_;
+        }
+
+        /**
+         * @brief Skip what is left of the payload and read the
+         * trailer.
+         *
+         * @return false There is no trailer.
+         */
+        bool trailer()
+        {
+            offset_ = std::min(end_, size_);
+            end_ = size_;
+            return ok_ && offset_ < end_;
+        }
+
+    private:
+        bool consume(std::size_t size)
+        {
+            if (ok_ && offset_ + size > end_) {
+                ok_ = false;
+            }
+            return ok_;
+        }
+
+        const char *data_;
+        std::size_t size_;
+        /**
+         * @brief The end of the part being read, the payload
+         * or the trailer.
+         *
+         */
+        std::size_t end_;
+        std::size_t offset_;
+        bool ok_;
+        MessageHeader header_;
+    };
+
+    /**
+     * @brief The range and precision a float is sent with: the
+     * range is split in 2^bits steps and the values outside it
+     * are clamped (wrapped for an angle).
+     *
+     * e.g. a position within [-1024, 3072[ on 16 bits is sent to
+     * the 1/16th of a pixel.
+     *
+     */
+    struct Quantization
+    {
+        float min;
+        float max;
+        /**
+         * @brief The number of bits, from 1 to 32.
+         *
+         */
+        std::uint8_t bits;
+        /**
+         * @brief The value is an angle, max being the same as min.
+         *
+         */
+        bool wrap;
+
+        std::uint32_t encode(float value) const
+        {
+            // on 64 bits, so the 2^32 steps of a 32 bits value don't overflow
+            std::uint64_t steps = std::uint64_t(1) << bits;
+            double step = (static_cast<double>(max) - min) / static_cast<double>(steps);
+            double q = std::round((value - static_cast<double>(min)) / step);
+
+            if (wrap) {
+                q = std::fmod(q, static_cast<double>(steps));
+                return static_cast<std::uint32_t>(static_cast<std::uint64_t>(q < 0.0 ? q + steps : q) & (steps - 1));
+            }
+            return static_cast<std::uint32_t>(std::clamp(q, 0.0, static_cast<double>(steps - 1)));
+        }
+
+        float decode(std::uint32_t value) const
+        {
+            std::uint64_t steps = std::uint64_t(1) << bits;
+
+            return static_cast<float>(min + static_cast<double>(value) * (static_cast<double>(max) - min) / static_cast<double>(steps));
+        }
+    };
+
+    /**
+     * @brief Packs values on the bits they need into a
+     * MessageWriter, e.g. a 7 bits key or a quantized float.
+     * The bits are written a byte at a time, the last partial
+     * byte by flush(), which must be called before
+     * MessageWriter::finish().
+     *
+     */
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(MessageWriter &writer)
+            : writer_(writer),
+              scratch_(0),
+              scratch_bits_(0)
+        {
+        }
+
+        /**
+         * @brief Write the low bits of a value.
+         *
+         * @param value The value, its upper bits are ignored.
+         * @param bits The number of bits written, up to 32.
+         */
+        void write_bits(std::uint32_t value, unsigned bits)
+        {
+            if (bits < 32) {
+                value &= (std::uint32_t(1) << bits) - 1;
+            }
+            scratch_ |= static_cast<std::uint64_t>(value) << scratch_bits_;
+            scratch_bits_ += bits;
+            while (scratch_bits_ >= 8) {
+                writer_.write(static_cast<std::uint8_t>(scratch_ & 0xff));
+                scratch_ >>= 8;
+                scratch_bits_ -= 8;
+            }
+        }
+
+        void write(float value, const Quantization &quantization)
+        {
+            write_bits(quantization.encode(value), quantization.bits);
+        }
+
+        /**
+         * @brief Write an integer on as many 7 bits groups as it
+         * needs, so the small values are sent on a byte.
+         *
+         */
+        void write_varint(std::uint64_t value)
+        {
+            do {
+                std::uint32_t group = static_cast<std::uint32_t>(value & 0x7f);
+
+                value >>= 7;
+                write_bits(group | (value ? 0x80 : 0), 8);
+            } while (value);
+        }
+
+        /**
+         * @brief Write the last partial byte, padded with zeros.
+         *
+         */
+        void flush()
+        {
+            if (scratch_bits_ > 0) {
+                writer_.write(static_cast<std::uint8_t>(scratch_ & 0xff));
+                scratch_ = 0;
+                scratch_bits_ = 0;
+            }
+        }
+
+        /**
+         * @brief Get the size of the message once flushed.
+         *
+         */
+        std::size_t size() const
+        {
+            return writer_.size() + (scratch_bits_ > 0 ? 1 : 0);
+        }
+
+    private:
+        MessageWriter &writer_;
+        std::uint64_t scratch_;
+        unsigned scratch_bits_;
+    };
+
+    /**
+     * @brief Reads the values written by a BitWriter, in the same
+     * order and on the same number of bits.
+     *
+     */
+    class BitReader
+    {
+    public:
+        explicit BitReader(MessageReader &reader)
+            : reader_(reader),
+              scratch_(0),
+              scratch_bits_(0)
+        {
+        }
+
+        bool read_bits(std::uint32_t &value, unsigned bits)
+        {
+            while (scratch_bits_ < bits) {
+                std::uint8_t byte = 0;
+
+                if (!reader_.read(byte)) {
+                    return false;
+                }
+                scratch_ |= static_cast<std::uint64_t>(byte) << scratch_bits_;
+                scratch_bits_ += 8;
+            }
+            value = static_cast<std::uint32_t>(scratch_ & ((std::uint64_t(1) << bits) - 1));
+            scratch_ >>= bits;
+            scratch_bits_ -= bits;
+            return true;
+        }
+
+        bool read(float &value, const Quantization &quantization)
+        {
+            std::uint32_t bits = 0;
+
+            if (!read_bits(bits, quantization.bits)) {
+                return false;
+            }
+            value = quantization.decode(bits);
+            return true;
+        }
+
+        bool read_varint(std::uint64_t &value)
+        {
+            std::uint32_t group = 0x80;
+
+            value = 0;
+            for (unsigned shift = 0; group & 0x80; shift += 7) {
+                if (shift >= 64 || !read_bits(group, 8)) {
+                    return false;
+                }
+                value |= static_cast<std::uint64_t>(group & 0x7f) << shift;
+            }
+            return true;
+        }
+
+        bool ok() const
+        {
+            return reader_.ok();
+        }
+
+        /**
+         * @brief Indicate if only the padding of the last byte
+         * is left.
+         *
+         */
+        bool done() const
+        {
+            return reader_.done() && scratch_bits_ < 8;
+        }
+
+    private:
+        MessageReader &reader_;
+        std::uint64_t scratch_;
+        unsigned scratch_bits_;
+    };
+
+    constexpr std::size_t K_MAX_INPUT_KEYS = 16;
+    /**
+     * @brief The bits of a pressed key, the keyboardInput
+     * values being below 128.
+     *
+     */
+    constexpr unsigned K_INPUT_KEY_BITS = 7;
+    /**
+     * @brief The bits of the number of pressed keys.
+     *
+     */
+    constexpr unsigned K_INPUT_COUNT_BITS = 5;
+
+    /**
+     * @brief The keys pressed by a player during a tick
+     * (keyboardInput values), each packed on K_INPUT_KEY_BITS.
+     *
+     */
+    struct InputMessage
+    {
+        std::uint32_t tick;
+        std::uint8_t key_count;
+        std::uint8_t keys[K_MAX_INPUT_KEYS];
+
+        void write(MessageWriter &writer) const
+        {
+            BitWriter bits(writer);
+            std::uint8_t count = std::min<std::uint8_t>(key_count, K_MAX_INPUT_KEYS);
+
+            writer.write(tick);
+            bits.write_bits(count, K_INPUT_COUNT_BITS);
+            for (std::uint8_t i = 0; i < count; i++) {
+                bits.write_bits(keys[i], K_INPUT_KEY_BITS);
+            }
+            bits.flush();
+        }
+
+        bool read(MessageReader &reader)
+        {
+            BitReader bits(reader);
+            std::uint32_t value = 0;
+
+            reader.read(tick);
+            if (!bits.read_bits(value, K_INPUT_COUNT_BITS) || value > K_MAX_INPUT_KEYS) {
+                return false;
+            }
+            key_count = static_cast<std::uint8_t>(value);
+            for (std::uint8_t i = 0; i < key_count; i++) {
+                if (!bits.read_bits(value, K_INPUT_KEY_BITS)) {
+                    return false;
+                }
+                keys[i] = static_cast<std::uint8_t>(value);
+            }
+            return true;
+        }
+    };
+
+    /**
+     * @brief The beginning of a part of a snapshot, followed by
+     * the entities changed since its baseline (see net_snapshot.h).
+     * A snapshot too big for a datagram is split in several parts.
+     *
+     */
+    struct SnapshotMessage
+    {
+        std::uint32_t tick;
+        /**
+         * @brief The tick of the snapshot the entities are
+         * delta-encoded against, K_NO_BASELINE if they are not.
+         *
+         */
+        std::uint32_t baseline;
+        std::uint16_t part;
+        /**
+         * @brief 1 if this is the last part of the snapshot.
+         *
+         */
+        std::uint8_t last;
+        /**
+         * @brief The tick of the last input of the client applied
+         * by the server, K_NO_INPUT if none was, for the client to
+         * replay the next ones over the snapshot.
+         *
+         */
+        std::uint32_t input_tick;
+
+        void write(MessageWriter &writer) const
+        {
+            writer.write(tick);
+            writer.write(baseline);
+            writer.write(part);
+            writer.write(last);
+            writer.write(input_tick);
+        }
+
+        bool read(MessageReader &reader)
+        {
+            reader.read(tick);
+            reader.read(baseline);
+            reader.read(part);
+            reader.read(last);
+            return reader.read(input_tick);
+        }
+    };
+
+    /**
+     * @brief The last snapshot fully received by a client, the
+     * server delta-encodes the next ones against it.
+     *
+     */
+    struct SnapshotAckMessage
+    {
+        std::uint32_t tick;
+
+        void write(MessageWriter &writer) const
+        {
+            writer.write(tick);
+        }
+
+        bool read(MessageReader &reader)
+        {
+            return reader.read(tick);
+        }
+    };
+
+    /**
+     * @brief Sent by a client every tick until the server spawns
+     * its player (see PREFAB_LOCAL_PLAYER). The server only sends
+     * to the endpoints it received from, so the first one makes
+     * the client join a room. It has no payload.
+     *
+     */
+    struct JoinMessage
+    {
+        void write(MessageWriter &) const
+        {
+        }
+
+        bool read(MessageReader &reader)
+        {
+            return reader.ok();
+        }
+    };
+
+    /**
+     * @brief The prefab of a SpawnMessage.
+     *
+     */
+    enum prefabType : std::uint8_t {
+        /**
+         * @brief The player entity of the client receiving the
+         * message, spawned when it joins a room.
+         *
+         */
+        PREFAB_LOCAL_PLAYER = 1,
+    };
+
+    /**
+     * @brief An entity created by the server, from a prefab.
+     *
+     */
+    struct SpawnMessage
+    {
+        std::uint64_t entity;
+        std::uint8_t prefab;
+        float x;
+        float y;
+
+        void write(MessageWriter &writer) const
+        {
+            writer.write(entity);
+            writer.write(prefab);
+            writer.write(x);
+            writer.write(y);
+        }
+
+        bool read(MessageReader &reader)
+        {
+            reader.read(entity);
+            reader.read(prefab);
+            reader.read(x);
+            return reader.read(y);
+        }
+    };
+
+    /**
+     * @brief An entity killed by the server.
+     *
+     */
+    struct DespawnMessage
+    {
+        std::uint64_t entity;
+
+        void write(MessageWriter &writer) const
+        {
+            writer.write(entity);
+        }
+
+        bool read(MessageReader &reader)
+        {
+            return reader.read(entity);
+        }
+    };
+
+    /**
+     * @brief A game event (e.g. a collision or a score change)
+     * between up to two entities.
+     *
+     */
+    struct EventMessage
     {
-        int id;
-        float value;
+        std::uint16_t event;
+        std::uint64_t entity_a;
+        std::uint64_t entity_b;
+        std::int32_t value;
+
+        void write(MessageWriter &writer) const
+        {
+            writer.write(event);
+            writer.write(entity_a);
+            writer.write(entity_b);
+            writer.write(value);
+        }
+
+        bool read(MessageReader &reader)
+        {
+            reader.read(event);
+            reader.read(entity_a);
+            reader.read(entity_b);
+            return reader.read(value);
+        }
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "net_common.h"
+#include "net_queue.h"
+
+namespace net
+{
+    constexpr int K_BUFFER_SIZE = 1024;
+
+    /**
+     * @brief A datagram and the endpoint it was received
+     * from (or is sent to).
+     *
+     */
+    struct Packet
+    {
+        boost::asio::ip::udp::endpoint endpoint;
+        std::size_t size;
+        std::array<char, K_BUFFER_SIZE> data;
+    };
+
+    /**
+     * @brief A fixed set of packets reused for every datagram,
+     * so receiving and sending never allocates. Packets can be
+     * acquired and released from any thread.
+     *
+     */
+    class PacketPool
+    {
+    public:
+        explicit PacketPool(std::size_t count)
+            : packets_(count),
+              free_(count)
+        {
+            for (Packet &packet : packets_) {
+                free_.try_push(&packet);
+            }
+        }
+
+        /**
+         * @brief Take a packet from the pool.
+         *
+         * @return Packet* The packet, nullptr if every packet
+         * is in use.
+         */
+        Packet *acquire()
+        {
+            Packet *packet = nullptr;
+
+            free_.try_pop(packet);
+            return packet;
+        }
+
+        /**
+         * @brief Give a packet back to the pool.
+         *
+         */
+        void release(Packet *packet)
+        {
+            free_.try_push(packet);
+        }
+
+    private:
+        std::vector<Packet> packets_;
+        BoundedQueue<Packet *> free_;
+    };
+
+    /**
+     * @brief The traffic counters of a socket.
+     *
+     */
+    struct SocketStats
+    {
+        std::uint64_t received;
+        std::uint64_t sent;
+        /**
+         * @brief The datagrams dropped because the receive
+         * queue was full (the consumer is too slow).
+         *
+         */
+        std::uint64_t dropped_queue_full;
+        /**
+         * @brief The datagrams, received or to be sent,
+         * dropped because no packet was left in the pool.
+         *
+         */
+        std::uint64_t dropped_no_buffer;
+        /**
+         * @brief The received datagrams dropped because they
+         * didn't fit in a packet. They are only detected by the
+         * batched receives, the others hand them truncated.
+         *
+         */
+        std::uint64_t dropped_truncated;
+        /**
+         * @brief The datagrams dropped because the socket
+         * refused to send them (e.g. unreachable endpoint).
+         *
+         */
+        std::uint64_t send_errors;
+    };
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+
+#include "Registry.hpp"
+#include "net_snapshot.h"
+
+namespace net
+{
+    /**
+     * @brief The number of inputs kept until the server applies
+     * them, 2 seconds of round trip at 60 ticks per second.
+     *
+     */
+    constexpr std::size_t K_PREDICTION_HISTORY = 128;
+
+    /**
+     * @brief Trigger the Input actions of an entity for the keys
+     * of an input message. The server and the predicting client
+     * both apply the inputs with it, so they move the player the
+     * same way.
+     *
+     */
+    inline void apply_input(Registry &r, const Entity &e, const InputMessage &input)
+    {
+        SparseArray<Component::Input> &inputs = r.get_components<Component::Input>();
+
+        if (!r.is_alive(e) || !inputs.doesContain(e)) {
+            return;
+        }
+        // copied, an action could add components and move the input
+        action_map actions = inputs.component_at(e).actions;
+
+        for (std::uint8_t i = 0; i < input.key_count; i++) {
+            auto it = actions.find(static_cast<keyboardInput>(input.keys[i]));
+
+            if (it != actions.end()) {
+                it->second();
+            }
+        }
+    }
+
+    /**
+     * @brief Predicts the local player on a client: each input is
+     * applied right away and the player simulated for a tick by
+     * the movement and physics systems, instead of waiting for the
+     * server. The inputs are kept until a snapshot shows they were
+     * applied by the server, then the player is rewound to the
+     * authoritative state and the inputs the server hasn't applied
+     * yet are replayed over it.
+     *
+     * The server is expected to apply an input per tick, before
+     * simulating the tick, and the predicted entity isn't moved by
+     * the client registry systems: SnapshotApplier::set_predicted()
+     * tags it Predicted.
+     *
+     * e.g:
+     * ```cpp
+     * // every tick
+     * prediction.predict(r, player, input);
+     * // every snapshot, once applied by the SnapshotApplier
+     * prediction.reconcile(r, player, snapshot, server_player);
+     * ```
+     *
+     */
+    class Prediction
+    {
+    public:
+        /**
+         * @brief Apply an input to the player and simulate it for
+         * a tick.
+         *
+         */
+        void predict(Registry &r, const Entity &player, const InputMessage &input)
+        {
+            if (history_.size() == K_PREDICTION_HISTORY) {
+                history_.pop_front();
+            }
+            history_.push_back(Predicted{input, {}, {}});
+            step(r, View(player), player, history_.back());
+        }
+
+        /**
+         * @brief Rewind the player to its state in a snapshot and
+         * replay the inputs the server didn't apply yet.
+         *
+         * @param r The registry of the client.
+         * @param player The local player entity.
+         * @param snapshot The last snapshot read.
+         * @param server_player The handle of the player entity
+         * on the server.
+         * @return float The distance between the predicted and the
+         * authoritative position of the player, once replayed.
+         */
+        float reconcile(Registry &r, const Entity &player, const Snapshot &snapshot, std::uint64_t server_player)
+        {
+            auto state = std::lower_bound(snapshot.entities.begin(), snapshot.entities.end(), server_player,
+                [](const EntitySnapshot &entity, std::uint64_t handle) { return entity_less(entity.entity, handle); });
+
+            if (state == snapshot.entities.end() || state->entity != server_player || !r.is_alive(player)) {
+                return 0.0f;
+            }
+            // the inputs applied by the server are part of the snapshot now
+            while (snapshot.input_tick != K_NO_INPUT && !history_.empty()
+                   && static_cast<std::int32_t>(history_.front().input.tick - snapshot.input_tick) <= 0) {
+                acceleration_ = history_.front().rigid_body.acceleration;
+                history_.pop_front();
+            }
+            SparseArray<Component::Transform> &transforms = r.get_components<Component::Transform>();
+            SparseArray<Component::RigidBody> &rigid_bodies = r.get_components<Component::RigidBody>();
+
+            if (!transforms.doesContain(player) || !rigid_bodies.doesContain(player)) {
+                return 0.0f;
+            }
+            Vec2 predicted = history_.empty() ? transforms.component_at(player).position : history_.back().transform.position;
+
+            transforms.component_at(player).position = Vec2(state->x, state->y);
+            rigid_bodies.component_at(player).velocity = Vec2(state->velocity_x, state->velocity_y);
+            // the acceleration isn't replicated, it is the predicted one
+            rigid_bodies.component_at(player).acceleration = acceleration_;
+            View view(player);
+
+            for (Predicted &entry : history_) {
+                step(r, view, player, entry);
+            }
+            Vec2 replayed = transforms.component_at(player).position;
+
+            return std::hypot(replayed.x - predicted.x, replayed.y - predicted.y);
+        }
+
+        /**
+         * @brief Get the number of inputs not applied by the
+         * server yet.
+         *
+         */
+        std::size_t get_pending_count() const
+        {
+            return history_.size();
+        }
+
+    private:
+        /**
+         * @brief An input and the state of the player once it
+         * was applied.
+         *
+         */
+        struct Predicted
+        {
+            InputMessage input;
+            Component::Transform transform;
+            Component::RigidBody rigid_body;
+        };
+
+        /**
+         * @brief Apply the input of an entry and simulate the
+         * player for a tick.
+         *
+         * @param view The view of the player only.
+         */
+        void step(Registry &r, const View &view, const Entity &player, Predicted &entry)
+        {
+            SparseArray<Component::Transform> &transforms = r.get_components<Component::Transform>();
+            SparseArray<Component::RigidBody> &rigid_bodies = r.get_components<Component::RigidBody>();
+
+            if (!r.is_alive(player) || !transforms.doesContain(player) || !rigid_bodies.doesContain(player)) {
+                return;
+            }
+            SparseArray<Component::PreviousTransform> &previous = r.get_components<Component::PreviousTransform>();
+
+            // the previous_transform_system skips the player, it is drawn from where the step starts
+            if (previous.doesContain(player)) {
+                previous.component_at(player).transform = transforms.component_at(player);
+            }
+            apply_input(r, player, entry.input);
+            // the same systems as the server, run on the player only
+            System::movement_system(r, view, transforms, rigid_bodies);
+            System::physics_system(r, view, rigid_bodies);
+            entry.transform = transforms.component_at(player);
+            entry.rigid_body = rigid_bodies.component_at(player);
+        }
+
+        std::deque<Predicted> history_;
+        /**
+         * @brief The acceleration of the player after the last
+         * input applied by the server.
+         *
+         */
+        Vec2 acceleration_{0.0f, 0.0f};
+    };
+}
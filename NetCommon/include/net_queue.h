@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace net
+{
+    /**
+     * @brief A bounded lock-free queue, safe with any number of
+     * producer and consumer threads (e.g. the network thread
+     * pushing received packets and the simulation thread popping
+     * them). Each cell carries a sequence number telling whether
+     * it is free for the next push or ready for the next pop, so
+     * a push and a pop never wait on each other. A push on a full
+     * queue fails instead of blocking, leaving the caller to drop.
+     *
+     * @tparam T The type of the values, cheap to move (e.g. a pointer).
+     */
+    template <typename T>
+    class BoundedQueue
+    {
+    public:
+        /**
+         * @brief Build the queue.
+         *
+         * @param capacity The number of values the queue holds,
+         * rounded up to a power of two.
+         */
+        explicit BoundedQueue(std::size_t capacity)
+            : cells_(),
+              mask_(0),
+              enqueue_pos_(0),
+              dequeue_pos_(0)
+        {
+            std::size_t size = 1;
+
+            while (size < capacity) {
+                size <<= 1;
+            }
+            cells_ = std::make_unique<Cell[]>(size);
+            mask_ = size - 1;
+            for (std::size_t i = 0; i < size; i++) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        BoundedQueue(const BoundedQueue &) = delete;
+        BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+        std::size_t capacity() const
+        {
+            return mask_ + 1;
+        }
+
+        /**
+         * @brief Push a value.
+         *
+         * @return false The queue is full, the value isn't pushed.
+         */
+        bool try_push(T value)
+        {
+            std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            Cell *cell;
+
+            while (true) {
+                cell = &cells_[pos & mask_];
+                std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+
+                if (diff == 0) {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            cell->value = std::move(value);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Pop the oldest value.
+         *
+         * @return false The queue is empty, value is left untouched.
+         */
+        bool try_pop(T &value)
+        {
+            std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            Cell *cell;
+
+            while (true) {
+                cell = &cells_[pos & mask_];
+                std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+
+                if (diff == 0) {
+                    if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = dequeue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            value = std::move(cell->value);
+            cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        std::unique_ptr<Cell[]> cells_;
+        std::size_t mask_;
+        // on their own cache lines, producers and consumers don't share them
+        alignas(64) std::atomic<std::size_t> enqueue_pos_;
+        alignas(64) std::atomic<std::size_t> dequeue_pos_;
+    };
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+#include "Registry.hpp"
+#include "net_snapshot.h"
+
+namespace net
+{
+    /**
+     * @brief Capture the replicated state of every entity with a
+     * Transform, by increasing index (so already sorted for
+     * encode_snapshot()).
+     *
+     * @param r The registry of the room.
+     * @param tick The tick simulated last.
+     * @param snapshot The snapshot to fill, its memory is reused.
+     */
+    inline void capture_snapshot(Registry &r, std::uint32_t tick, Snapshot &snapshot)
+    {
+        SparseArray<Component::Transform> &transforms = r.get_components<Component::Transform>();
+        SparseArray<Component::RigidBody> &rigid_bodies = r.get_components<Component::RigidBody>();
+        SparseArray<Component::Sprite> &sprites = r.get_components<Component::Sprite>();
+        SparseArray<Component::Mortal> &mortals = r.get_components<Component::Mortal>();
+
+        snapshot.tick = tick;
+        snapshot.entities.clear();
+        for (auto &&[idx, tf] : containers::IndexedZipper(transforms)) {
+            EntitySnapshot entity{};
+
+            entity.entity = r.entity_from_index(idx).get_handle();
+            entity.components = REPLICATED_TRANSFORM;
+            entity.x = tf.position.x;
+            entity.y = tf.position.y;
+            entity.rotation = tf.rotation;
+            entity.scale_x = tf.scale.x;
+            entity.scale_y = tf.scale.y;
+            if (rigid_bodies.doesContain(idx)) {
+                Component::RigidBody const &rigid_body = rigid_bodies.component_at(idx);
+
+                entity.components |= REPLICATED_RIGID_BODY;
+                entity.velocity_x = rigid_body.velocity.x;
+                entity.velocity_y = rigid_body.velocity.y;
+            }
+            if (sprites.doesContain(idx)) {
+                std::string const &name = sprites.component_at(idx).texture_name;
+
+                entity.components |= REPLICATED_SPRITE;
+                entity.texture_size = static_cast<std::uint8_t>(std::min(name.size(), K_MAX_TEXTURE_NAME));
+                std::memcpy(entity.texture, name.data(), entity.texture_size);
+            }
+            if (mortals.doesContain(idx)) {
+                entity.components |= REPLICATED_MORTAL;
+                entity.health = static_cast<std::uint32_t>(mortals.component_at(idx).health_points);
+            }
+            snapshot.entities.push_back(entity);
+        }
+    }
+
+    /**
+     * @brief Mirrors the entities of the server in the registry
+     * of a client. The server entities are spawned, updated and
+     * killed to match each snapshot read by SnapshotDecoder.
+     * Their Transform states are buffered in an Interpolated
+     * component, rendered behind the server by the interpolation
+     * system, except for the predicted player (see Prediction),
+     * which is tagged Predicted instead and given the Input
+     * actions of a player.
+     *
+     */
+    class SnapshotApplier
+    {
+    public:
+        SnapshotApplier()
+            : predicted_(0),
+              has_predicted_(false)
+        {
+        }
+
+        /**
+         * @brief Set the server entity predicted by the client.
+         * From the next snapshot, it isn't interpolated and is
+         * tagged Predicted, so the client systems don't move it.
+         *
+         */
+        void set_predicted(std::uint64_t server_entity)
+        {
+            predicted_ = server_entity;
+            has_predicted_ = true;
+        }
+
+        /**
+         * @brief Update the local entities to the state of a
+         * snapshot. The entities missing from it are killed.
+         *
+         */
+        void apply(Registry &r, const Snapshot &snapshot)
+        {
+            double time = static_cast<double>(snapshot.tick) * r.get_timestep().get_delta_time();
+
+            r.get_interpolation_clock().sync(time);
+            for (const EntitySnapshot &state : snapshot.entities) {
+                auto it = entities_.find(state.entity);
+
+                if (it == entities_.end() || !r.is_alive(it->second.local)) {
+                    it = entities_.insert_or_assign(state.entity, Mirror{r.spawn_entity(), 0}).first;
+                }
+                it->second.tick = snapshot.tick;
+                apply_entity(r, it->second.local, state);
+                if (!has_predicted_ || state.entity != predicted_) {
+                    interpolate(r, it->second.local, state, time);
+                    unpredict(r, it->second.local);
+                } else {
+                    remove_if_present<Component::Interpolated>(r, it->second.local);
+                    predict(r, it->second.local);
+                }
+            }
+            for (auto it = entities_.begin(); it != entities_.end();) {
+                if (it->second.tick != snapshot.tick) {
+                    r.kill_entity(it->second.local);
+                    it = entities_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        /**
+         * @brief Get the local entity mirroring a server entity.
+         *
+         * @return const Entity* The local entity, nullptr if the
+         * server entity isn't replicated.
+         */
+        const Entity *find(std::uint64_t server_entity) const
+        {
+            auto it = entities_.find(server_entity);
+
+            return it == entities_.end() ? nullptr : &it->second.local;
+        }
+
+    private:
+        struct Mirror
+        {
+            Entity local;
+            /**
+             * @brief The tick of the last snapshot the entity
+             * was in.
+             *
+             */
+            std::uint32_t tick;
+        };
+
+        template <typename Component>
+        static void remove_if_present(Registry &r, const Entity &e)
+        {
+            if (r.get_components<Component>().doesContain(e)) {
+                r.remove_component<Component>(e);
+            }
+        }
+
+        static void apply_entity(Registry &r, const Entity &e, const EntitySnapshot &state)
+        {
+            if (state.components & REPLICATED_TRANSFORM) {
+                Component::Transform transform{.position = Vec2(state.x, state.y), .rotation = state.rotation, .scale = Vec2(state.scale_x, state.scale_y)};
+
+                // a new entity is drawn from where it is received, not from the origin
+                if (!r.get_components<Component::PreviousTransform>().doesContain(e)) {
+                    r.add_component(e, Component::PreviousTransform{.transform = transform});
+                }
+                r.add_component(e, std::move(transform));
+            } else {
+                remove_if_present<Component::Transform>(r, e);
+                remove_if_present<Component::PreviousTransform>(r, e);
+            }
+            if (state.components & REPLICATED_RIGID_BODY) {
+                SparseArray<Component::RigidBody> &rigid_bodies = r.get_components<Component::RigidBody>();
+                Vec2 velocity(state.velocity_x, state.velocity_y);
+
+                if (rigid_bodies.doesContain(e)) {
+                    rigid_bodies.component_at(e).velocity = velocity;
+                } else {
+                    r.add_component(e, Component::RigidBody{.mass = 1.0f, .velocity = velocity, .acceleration = Vec2(0.0f, 0.0f)});
+                }
+            } else {
+                remove_if_present<Component::RigidBody>(r, e);
+            }
+            if (state.components & REPLICATED_SPRITE) {
+                SparseArray<Component::Sprite> &sprites = r.get_components<Component::Sprite>();
+                std::string name(state.texture, state.texture_size);
+
+                // the texture rarely changes, don't reallocate its name every tick
+                if (!sprites.doesContain(e) || sprites.component_at(e).texture_name != name) {
+                    r.add_component(e, Component::Sprite{.texture_name = std::move(name)});
+                }
+            } else {
+                remove_if_present<Component::Sprite>(r, e);
+            }
+            if (state.components & REPLICATED_MORTAL) {
+                r.add_component(e, Component::Mortal{.health_points = state.health, .entity_id = e});
+            } else {
+                remove_if_present<Component::Mortal>(r, e);
+            }
+        }
+
+        static void predict(Registry &r, const Entity &e)
+        {
+            if (r.get_components<Component::Predicted>().doesContain(e)) {
+                return;
+            }
+            r.add_component(e, Component::Predicted{});
+            // the same actions as the server player, for apply_input()
+            r.add_component(e, Component::Input{.actions = Prefab::Player::actions(r, e)});
+        }
+
+        static void unpredict(Registry &r, const Entity &e)
+        {
+            if (r.get_components<Component::Predicted>().doesContain(e)) {
+                r.remove_component<Component::Predicted>(e);
+                remove_if_present<Component::Input>(r, e);
+            }
+        }
+
+        static void interpolate(Registry &r, const Entity &e, const EntitySnapshot &state, double time)
+        {
+            SparseArray<Component::Interpolated> &interpolated = r.get_components<Component::Interpolated>();
+
+            if (!(state.components & REPLICATED_TRANSFORM)) {
+                remove_if_present<Component::Interpolated>(r, e);
+                return;
+            }
+            if (!interpolated.doesContain(e)) {
+                r.add_component(e, Component::Interpolated{});
+            }
+            interpolated.component_at(e).push(time, r.get_components<Component::Transform>().component_at(e));
+        }
+
+        std::unordered_map<std::uint64_t, Mirror> entities_;
+        std::uint64_t predicted_;
+        bool has_predicted_;
+    };
+}
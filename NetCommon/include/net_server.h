@@ -1,85 +1,99 @@
 #pragma once
 
+#include <limits>
+
 #include "net_common.h"
 #include "net_message.h"
+#include "net_socket.h"
 
 using namespace boost::asio;
 using boost::asio::ip::udp;
 
-constexpr int K_BUFFER_SIZE = 1024;
-
 namespace net
 {
+    constexpr std::size_t K_SERVER_QUEUE_SIZE = 4096;
+
+    /**
+     * @brief A UDP server. The datagrams are received by the
+     * thread running the io_context and drained by the
+     * simulation thread with poll() (see PacketSocket).
+     *
+     */
     class UdpServer
     {
     public:
-        UdpServer(io_context &io_context, udp::endpoint endpoint)
-            : socket_(io_context, endpoint),
-              stop_flag_(false)
+        UdpServer(io_context &io_context, udp::endpoint endpoint, std::size_t queue_size = K_SERVER_QUEUE_SIZE)
+            : socket_(io_context, endpoint, queue_size)
         {
-            start_receive();
+            std::cout << "Listening on " << socket_.local_endpoint() << std::endl;
         }
 
-        ~UdpServer()
+        void stop()
         {
-            stop();
+            socket_.stop();
         }
 
-        void stop()
+        /**
+         * @brief Send a datagram, see PacketSocket::send().
+         *
+         */
+        void send(const void *data, std::size_t size, const udp::endpoint &endpoint)
         {
-            if (!stop_flag_) {
-                stop_flag_ = true;
-                socket_.close();
-            }
+            socket_.send(data, size, endpoint);
         }
 
-        void send_data(const DataPacket &data, udp::endpoint &endpoint)
+        /**
+         * @brief Take a packet to write a message into, see
+         * PacketSocket::acquire_packet().
+         *
+         */
+        Packet *acquire_packet()
         {
-            socket_.async_send_to(
-                buffer(&data, sizeof(data)), endpoint,
-                [](boost::system::error_code ec, std::size_t /*bytes_sent*/)
-                {
-                    if (ec) {
-                        std::cerr << "Error: " << ec.message() << std::endl;
-                    }
-                });
+            return socket_.acquire_packet();
         }
 
-    private:
-        void start_receive()
+        void release_packet(Packet *packet)
         {
-            if (socket_.is_open()) {
-                // The socket is open and the file descriptor is valid.
-                std::cout << "Listening on " << socket_.local_endpoint() << std::endl;
-            }
-            socket_.async_receive_from(
-                buffer(data_), sender_endpoint_,
-                [this](boost::system::error_code ec, std::size_t bytes_received)
-                {
-                    std::cout << "Client endpoint " << sender_endpoint_ << std::endl;
-                    if (!ec && bytes_received == sizeof(DataPacket)) {
-                        std::thread([this](){process_data();}).detach();
-                    }
-                    if (!stop_flag_) {
-                        start_receive();
-                    }
-                }
-            );
+            socket_.release_packet(packet);
         }
 
-        void process_data()
+        /**
+         * @brief Send a packet taken with acquire_packet(), see
+         * PacketSocket::send_packet().
+         *
+         */
+        void send_packet(Packet *packet, const udp::endpoint &endpoint)
         {
-            DataPacket *data = reinterpret_cast<DataPacket *>(data_.data());
-            std::cout << "Received data from " << sender_endpoint_ << ": id=" << data->id
-                      << ", value=" << data->value << std::endl;
+            socket_.send_packet(packet, endpoint);
+        }
 
-            // Send the data back to the sender
-            send_data(*data, sender_endpoint_);
+        /**
+         * @brief Handle the received datagrams, see
+         * PacketSocket::poll().
+         *
+         */
+        template <typename Handler>
+        std::size_t poll(Handler &&handler, std::size_t max = std::numeric_limits<std::size_t>::max())
+        {
+            return socket_.poll(std::forward<Handler>(handler), max);
         }
 
-        udp::socket socket_;
-        udp::endpoint sender_endpoint_;
-        std::array<char, sizeof(DataPacket)> data_;
-        bool stop_flag_;
+        SocketStats get_stats() const
+        {
+            return socket_.get_stats();
+        }
+
+        /**
+         * @brief Get the endpoint the server listens on, e.g.
+         * the port picked when bound to port 0.
+         *
+         */
+        udp::endpoint local_endpoint() const
+        {
+            return socket_.local_endpoint();
+        }
+
+    private:
+        PacketSocket socket_;
     };
-}
\ No newline at end of file
+}
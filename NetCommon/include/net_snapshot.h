@@ -0,0 +1,743 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include "net_channel.h"
+#include "net_message.h"
+
+namespace net
+{
+    constexpr std::size_t K_MAX_TEXTURE_NAME = 31;
+    /**
+     * @brief The number of snapshots kept as possible baselines,
+     * about half a second at 60 ticks per second.
+     *
+     */
+    constexpr std::size_t K_SNAPSHOT_HISTORY = 32;
+    /**
+     * @brief The maximum number of datagrams of a snapshot.
+     *
+     */
+    constexpr std::size_t K_MAX_SNAPSHOT_PARTS = 1024;
+
+    /**
+     * @brief The replicated components an entity has.
+     *
+     */
+    enum replicatedComponent : std::uint8_t {
+        REPLICATED_TRANSFORM = 1 << 0,
+        REPLICATED_RIGID_BODY = 1 << 1,
+        REPLICATED_SPRITE = 1 << 2,
+        REPLICATED_MORTAL = 1 << 3,
+    };
+
+    /**
+     * @brief The fields of an entity written in a snapshot, the
+     * ones that changed since the baseline.
+     *
+     */
+    enum snapshotField : std::uint8_t {
+        FIELD_COMPONENTS = 1 << 0,
+        FIELD_POSITION = 1 << 1,
+        FIELD_ROTATION = 1 << 2,
+        FIELD_SCALE = 1 << 3,
+        FIELD_VELOCITY = 1 << 4,
+        FIELD_TEXTURE = 1 << 5,
+        FIELD_HEALTH = 1 << 6,
+        /**
+         * @brief The entity is in the baseline but not in the
+         * snapshot anymore.
+         *
+         */
+        FIELD_REMOVED = 1 << 7,
+    };
+
+    /**
+     * @brief How the fields of each replicated component are
+     * packed in a snapshot. The playfield (1920x1080) and the
+     * entities entering or leaving it fit in the position range.
+     *
+     */
+    namespace quantization
+    {
+        struct Transform
+        {
+            static constexpr Quantization POSITION{-1024.0f, 3072.0f, 16, false};
+            static constexpr Quantization ROTATION{0.0f, 360.0f, 10, true};
+            static constexpr Quantization SCALE{0.0f, 16.0f, 8, false};
+        };
+
+        struct RigidBody
+        {
+            static constexpr Quantization VELOCITY{-2048.0f, 2048.0f, 16, false};
+        };
+
+        struct Sprite
+        {
+            static constexpr unsigned TEXTURE_SIZE_BITS = 5;
+        };
+
+        struct Mortal
+        {
+            /**
+             * @brief The health is clamped to 255.
+             *
+             */
+            static constexpr unsigned HEALTH_BITS = 8;
+        };
+
+        constexpr unsigned COMPONENTS_BITS = 4;
+        constexpr unsigned FIELDS_BITS = 8;
+    }
+
+    static_assert((std::size_t(1) << quantization::Sprite::TEXTURE_SIZE_BITS) > K_MAX_TEXTURE_NAME, "the texture size doesn't fit");
+
+    /**
+     * @brief Write an entity handle as the difference between its
+     * index and the one of the previous entity of the datagram
+     * (the entities being sorted by index), then its generation,
+     * so both usually fit on a byte.
+     *
+     */
+    inline void write_entity(BitWriter &bits, std::uint64_t entity, std::uint32_t &previous_index)
+    {
+        std::uint32_t index = static_cast<std::uint32_t>(entity);
+
+        bits.write_varint(index - previous_index);
+        bits.write_varint(entity >> 32);
+        previous_index = index;
+    }
+
+    inline bool read_entity(BitReader &bits, std::uint64_t &entity, std::uint32_t &previous_index)
+    {
+        std::uint64_t delta = 0;
+        std::uint64_t generation = 0;
+
+        if (!bits.read_varint(delta) || !bits.read_varint(generation) || delta > 0xffffffff || generation > 0xffffffff) {
+            return false;
+        }
+        previous_index += static_cast<std::uint32_t>(delta);
+        entity = (generation << 32) | previous_index;
+        return true;
+    }
+
+    /**
+     * @brief The replicated state of an entity: its Transform,
+     * RigidBody velocity, Sprite texture and Mortal health.
+     * The fields are compared and sent with the precision given
+     * by their quantization.
+     *
+     */
+    struct EntitySnapshot
+    {
+        std::uint64_t entity;
+        std::uint8_t components;
+        float x;
+        float y;
+        float rotation;
+        float scale_x;
+        float scale_y;
+        float velocity_x;
+        float velocity_y;
+        std::uint8_t texture_size;
+        char texture[K_MAX_TEXTURE_NAME];
+        std::uint32_t health;
+
+        /**
+         * @brief Get the fields that differ from a baseline
+         * state of the same entity.
+         *
+         */
+        std::uint8_t changes(const EntitySnapshot &baseline) const
+        {
+            std::uint8_t fields = 0;
+
+            if (components != baseline.components) {
+                fields |= FIELD_COMPONENTS;
+            }
+            if ((components & REPLICATED_TRANSFORM) && (differ(x, baseline.x, quantization::Transform::POSITION) || differ(y, baseline.y, quantization::Transform::POSITION))) {
+                fields |= FIELD_POSITION;
+            }
+            if ((components & REPLICATED_TRANSFORM) && differ(rotation, baseline.rotation, quantization::Transform::ROTATION)) {
+                fields |= FIELD_ROTATION;
+            }
+            if ((components & REPLICATED_TRANSFORM) && (differ(scale_x, baseline.scale_x, quantization::Transform::SCALE) || differ(scale_y, baseline.scale_y, quantization::Transform::SCALE))) {
+                fields |= FIELD_SCALE;
+            }
+            if ((components & REPLICATED_RIGID_BODY) && (differ(velocity_x, baseline.velocity_x, quantization::RigidBody::VELOCITY) || differ(velocity_y, baseline.velocity_y, quantization::RigidBody::VELOCITY))) {
+                fields |= FIELD_VELOCITY;
+            }
+            if ((components & REPLICATED_SPRITE) && (texture_size != baseline.texture_size || std::memcmp(texture, baseline.texture, texture_size) != 0)) {
+                fields |= FIELD_TEXTURE;
+            }
+            if ((components & REPLICATED_MORTAL) && clamped_health() != baseline.clamped_health()) {
+                fields |= FIELD_HEALTH;
+            }
+            return fields;
+        }
+
+        /**
+         * @brief Get every field of the components of the entity,
+         * when there is no baseline state of it.
+         *
+         */
+        std::uint8_t all_fields() const
+        {
+            std::uint8_t fields = FIELD_COMPONENTS;
+
+            if (components & REPLICATED_TRANSFORM) {
+                fields |= FIELD_POSITION | FIELD_ROTATION | FIELD_SCALE;
+            }
+            if (components & REPLICATED_RIGID_BODY) {
+                fields |= FIELD_VELOCITY;
+            }
+            if (components & REPLICATED_SPRITE) {
+                fields |= FIELD_TEXTURE;
+            }
+            if (components & REPLICATED_MORTAL) {
+                fields |= FIELD_HEALTH;
+            }
+            return fields;
+        }
+
+        /**
+         * @brief Write the fields of the entity, after its handle
+         * (see write_entity()) and the fields mask.
+         *
+         */
+        void write(BitWriter &bits, std::uint8_t fields) const
+        {
+            if (fields & FIELD_COMPONENTS) {
+                bits.write_bits(components, quantization::COMPONENTS_BITS);
+            }
+            if (fields & FIELD_POSITION) {
+                bits.write(x, quantization::Transform::POSITION);
+                bits.write(y, quantization::Transform::POSITION);
+            }
+            if (fields & FIELD_ROTATION) {
+                bits.write(rotation, quantization::Transform::ROTATION);
+            }
+            if (fields & FIELD_SCALE) {
+                bits.write(scale_x, quantization::Transform::SCALE);
+                bits.write(scale_y, quantization::Transform::SCALE);
+            }
+            if (fields & FIELD_VELOCITY) {
+                bits.write(velocity_x, quantization::RigidBody::VELOCITY);
+                bits.write(velocity_y, quantization::RigidBody::VELOCITY);
+            }
+            if (fields & FIELD_TEXTURE) {
+                bits.write_bits(texture_size, quantization::Sprite::TEXTURE_SIZE_BITS);
+                for (std::uint8_t i = 0; i < texture_size; i++) {
+                    bits.write_bits(static_cast<std::uint8_t>(texture[i]), 8);
+                }
+            }
+            if (fields & FIELD_HEALTH) {
+                bits.write_bits(clamped_health(), quantization::Mortal::HEALTH_BITS);
+            }
+        }
+
+        /**
+         * @brief Read the fields written over the baseline state
+         * of the entity (or a zeroed state).
+         *
+         */
+        bool read(BitReader &bits, std::uint8_t fields)
+        {
+            std::uint32_t value = 0;
+
+            if ((fields & FIELD_COMPONENTS) && bits.read_bits(value, quantization::COMPONENTS_BITS)) {
+                components = static_cast<std::uint8_t>(value);
+            }
+            if (fields & FIELD_POSITION) {
+                bits.read(x, quantization::Transform::POSITION);
+                bits.read(y, quantization::Transform::POSITION);
+            }
+            if (fields & FIELD_ROTATION) {
+                bits.read(rotation, quantization::Transform::ROTATION);
+            }
+            if (fields & FIELD_SCALE) {
+                bits.read(scale_x, quantization::Transform::SCALE);
+                bits.read(scale_y, quantization::Transform::SCALE);
+            }
+            if (fields & FIELD_VELOCITY) {
+                bits.read(velocity_x, quantization::RigidBody::VELOCITY);
+                bits.read(velocity_y, quantization::RigidBody::VELOCITY);
+            }
+            if ((fields & FIELD_TEXTURE) && bits.read_bits(value, quantization::Sprite::TEXTURE_SIZE_BITS)) {
+                if (value > K_MAX_TEXTURE_NAME) {
+                    return false;
+                }
+                texture_size = static_cast<std::uint8_t>(value);
+                for (std::uint8_t i = 0; i < texture_size && bits.read_bits(value, 8); i++) {
+                    texture[i] = static_cast<char>(value);
+                }
+            }
+            if ((fields & FIELD_HEALTH) && bits.read_bits(value, quantization::Mortal::HEALTH_BITS)) {
+                health = value;
+            }
+            return bits.ok();
+        }
+
+    private:
+        static bool differ(float value, float baseline, const Quantization &quantization)
+        {
+            // most entities don't move, only quantize the values that changed
+            return value != baseline && quantization.encode(value) != quantization.encode(baseline);
+        }
+
+        std::uint32_t clamped_health() const
+        {
+            return std::min<std::uint32_t>(health, (1 << quantization::Mortal::HEALTH_BITS) - 1);
+        }
+    };
+
+    /**
+     * @brief The largest entity written in a snapshot, in bytes:
+     * its handle (two varints of up to 5 bytes), then every field.
+     *
+     */
+    constexpr std::size_t K_MAX_ENTITY_SIZE = 10 + (quantization::FIELDS_BITS + quantization::COMPONENTS_BITS
+        + 2 * quantization::Transform::POSITION.bits + quantization::Transform::ROTATION.bits + 2 * quantization::Transform::SCALE.bits
+        + 2 * quantization::RigidBody::VELOCITY.bits + quantization::Sprite::TEXTURE_SIZE_BITS + 8 * K_MAX_TEXTURE_NAME
+        + quantization::Mortal::HEALTH_BITS + 7) / 8;
+
+    /**
+     * @brief The offset of SnapshotMessage::last in the payload.
+     *
+     */
+    constexpr std::size_t K_SNAPSHOT_LAST_OFFSET = 2 * sizeof(std::uint32_t) + sizeof(std::uint16_t);
+
+    /**
+     * @brief The order of the entities in a snapshot: by index
+     * (the low half of the handle), then by generation. Entities
+     * captured by increasing index are then already sorted.
+     *
+     */
+    inline bool entity_less(std::uint64_t lhs, std::uint64_t rhs)
+    {
+        std::uint32_t lhs_index = static_cast<std::uint32_t>(lhs);
+        std::uint32_t rhs_index = static_cast<std::uint32_t>(rhs);
+
+        return lhs_index < rhs_index || (lhs_index == rhs_index && lhs < rhs);
+    }
+
+    /**
+     * @brief Compares entity handles with entity_less().
+     *
+     */
+    struct EntityLess
+    {
+        bool operator()(std::uint64_t lhs, std::uint64_t rhs) const
+        {
+            return entity_less(lhs, rhs);
+        }
+    };
+
+    /**
+     * @brief The replicated state of the game at a tick, the
+     * entities being sorted with entity_less().
+     *
+     */
+    struct Snapshot
+    {
+        std::uint32_t tick;
+        std::vector<EntitySnapshot> entities;
+        /**
+         * @brief The last input applied by the server, set on the
+         * snapshots read by a client (see SnapshotMessage).
+         *
+         */
+        std::uint32_t input_tick = K_NO_INPUT;
+    };
+
+    /**
+     * @brief The last snapshots, the baselines the next ones
+     * can be delta-encoded against. The snapshots are kept in
+     * a ring allocated once, and a new snapshot is written in
+     * the slot of the oldest one, reusing its memory.
+     *
+     * e.g:
+     * ```cpp
+     * Snapshot &snapshot = history.next();
+     *
+     * capture_snapshot(r, tick, snapshot);
+     * encode_snapshot(snapshot, history.find(client.acked_tick), ...);
+     * history.push();
+     * ```
+     *
+     */
+    class SnapshotHistory
+    {
+    public:
+        SnapshotHistory()
+            : snapshots_(K_SNAPSHOT_HISTORY + 1),
+              next_(0),
+              count_(0)
+        {
+        }
+
+        /**
+         * @brief Get the snapshot to write before push(). It isn't
+         * part of the history yet, so the baselines found while it
+         * is written stay valid.
+         *
+         */
+        Snapshot &next()
+        {
+            return snapshots_[next_];
+        }
+
+        /**
+         * @brief Add the snapshot written in next(), dropping the
+         * oldest one when the history is full. The ticks must
+         * increase.
+         *
+         */
+        const Snapshot &push()
+        {
+            const Snapshot &snapshot = snapshots_[next_];
+
+            next_ = (next_ + 1) % snapshots_.size();
+            count_ = std::min(count_ + 1, K_SNAPSHOT_HISTORY);
+            return snapshot;
+        }
+
+        /**
+         * @brief Add a copy of a snapshot, see push().
+         *
+         */
+        const Snapshot &push(const Snapshot &snapshot)
+        {
+            next() = snapshot;
+            return push();
+        }
+
+        /**
+         * @brief Get the snapshot of a tick, nullptr if it isn't
+         * in the history anymore.
+         *
+         */
+        const Snapshot *find(std::uint32_t tick) const
+        {
+            for (std::size_t i = 1; i <= count_; i++) {
+                const Snapshot &snapshot = at(i);
+
+                if (snapshot.tick == tick) {
+                    return &snapshot;
+                }
+            }
+            return nullptr;
+        }
+
+        const Snapshot *latest() const
+        {
+            return count_ == 0 ? nullptr : &at(1);
+        }
+
+    private:
+        /**
+         * @brief Get the snapshot pushed age pushes ago, 1 being
+         * the latest one.
+         *
+         */
+        const Snapshot &at(std::size_t age) const
+        {
+            return snapshots_[(next_ + snapshots_.size() - age) % snapshots_.size()];
+        }
+
+        /**
+         * @brief The history and the slot of the next snapshot.
+         *
+         */
+        std::vector<Snapshot> snapshots_;
+        std::size_t next_;
+        std::size_t count_;
+    };
+
+    /**
+     * @brief Write a snapshot delta-encoded against a baseline
+     * (the last snapshot acknowledged by the client): only the
+     * changed fields of the changed, added and removed entities
+     * are written, so the size follows what moved rather than the
+     * number of entities. The entities are split in as many
+     * datagrams as needed, each taken with acquire and given to
+     * send once written. Every datagram leaves K_RELIABLE_BUDGET
+     * bytes to the reliable messages stamped on it (see
+     * Connection::stamp()).
+     *
+     * e.g:
+     * ```cpp
+     * const Snapshot *baseline = history.find(client.acked_tick);
+     *
+     * encode_snapshot(snapshot, baseline, client.input_tick, header,
+     *                 [&]() { return server.acquire_packet(); },
+     *                 [&](Packet *packet) { server.send_packet(packet, client.endpoint); });
+     * ```
+     *
+     * @param snapshot The snapshot to be sent.
+     * @param baseline The baseline, nullptr to send the whole snapshot.
+     * @param input_tick The last input of the client applied.
+     * @param header The header of the datagrams, its type is set.
+     * @param acquire Returns a pooled packet, or nullptr.
+     * @param send Sends a written packet.
+     * @return std::size_t The number of bytes sent, headers included.
+     */
+    template <typename Acquire, typename Send>
+    std::size_t encode_snapshot(const Snapshot &snapshot, const Snapshot *baseline, std::uint32_t input_tick, MessageHeader header, Acquire &&acquire, Send &&send)
+    {
+        static const std::vector<EntitySnapshot> no_entities;
+        const std::vector<EntitySnapshot> &previous = baseline ? baseline->entities : no_entities;
+        const std::vector<EntitySnapshot> &current = snapshot.entities;
+        std::size_t sent = 0;
+        std::uint16_t part = 0;
+        Packet *packet = nullptr;
+        std::uint32_t previous_index = 0;
+        std::optional<MessageWriter> writer;
+        std::optional<BitWriter> bits;
+        auto flush = [&](bool last)
+        {
+            if (!packet) {
+                return;
+            }
+            // the last flag is the last byte of the SnapshotMessage, only known now
+            packet->data[K_HEADER_SIZE + K_SNAPSHOT_LAST_OFFSET] = last ? 1 : 0;
+            bits->flush();
+            if (writer->finish(header)) {
+                sent += packet->size;
+                send(packet);
+            }
+            packet = nullptr;
+            bits.reset();
+            writer.reset();
+        };
+        auto start = [&]() -> bool
+        {
+            // the end of the datagram is left to the reliable messages
+            if (packet && bits->size() + K_MAX_ENTITY_SIZE + K_RELIABLE_BUDGET <= K_BUFFER_SIZE) {
+                return true;
+            }
+            flush(false);
+            packet = acquire();
+            if (!packet) {
+                return false;
+            }
+            writer.emplace(*packet);
+            SnapshotMessage{snapshot.tick, baseline ? baseline->tick : K_NO_BASELINE, part++, 0, input_tick}.write(*writer);
+            // the entities follow, bit-packed, their index relative to the previous one
+            bits.emplace(*writer);
+            previous_index = 0;
+            return true;
+        };
+        auto write = [&](const EntitySnapshot &entity, std::uint8_t fields)
+        {
+            write_entity(*bits, entity.entity, previous_index);
+            bits->write_bits(fields, quantization::FIELDS_BITS);
+            entity.write(*bits, fields);
+        };
+        std::size_t i = 0;
+        std::size_t j = 0;
+
+        header.type = MESSAGE_SNAPSHOT;
+        while (i < current.size() || j < previous.size()) {
+            if (j == previous.size() || (i < current.size() && entity_less(current[i].entity, previous[j].entity))) {
+                if (!start()) {
+                    return sent;
+                }
+                write(current[i], current[i].all_fields());
+                ++i;
+            } else if (i == current.size() || entity_less(previous[j].entity, current[i].entity)) {
+                if (!start()) {
+                    return sent;
+                }
+                write(previous[j], FIELD_REMOVED);
+                ++j;
+            } else {
+                std::uint8_t fields = current[i].changes(previous[j]);
+
+                if (fields != 0) {
+                    if (!start()) {
+                        return sent;
+                    }
+                    write(current[i], fields);
+                }
+                ++i;
+                ++j;
+            }
+        }
+        // an unchanged snapshot still sends its (empty) part, to be acknowledged
+        if (!packet && !start()) {
+            return sent;
+        }
+        flush(true);
+        return sent;
+    }
+
+    /**
+     * @brief Rebuilds the snapshots sent by encode_snapshot()
+     * from their parts, on top of their baseline.
+     *
+     */
+    class SnapshotDecoder
+    {
+    public:
+        /**
+         * @brief Read a part of a snapshot.
+         *
+         * @param reader The reader of a MESSAGE_SNAPSHOT datagram,
+         * its header already read.
+         * @return const Snapshot* The snapshot once every part of
+         * it is read, to be acknowledged, nullptr otherwise.
+         */
+        const Snapshot *read(MessageReader &reader)
+        {
+            SnapshotMessage message;
+
+            if (!message.read(reader) || (latest_ && !newer(message.tick, *latest_))) {
+                return nullptr;
+            }
+            Assembly *assembly = find_assembly(message);
+
+            if (!assembly || message.part >= K_MAX_SNAPSHOT_PARTS || has_part(*assembly, message.part)) {
+                return nullptr;
+            }
+            std::map<std::uint64_t, EntitySnapshot, EntityLess> changes;
+            BitReader bits(reader);
+            std::uint32_t previous_index = 0;
+
+            while (!bits.done()) {
+                EntitySnapshot entity{};
+                std::uint32_t fields = 0;
+
+                if (!read_entity(bits, entity.entity, previous_index) || !bits.read_bits(fields, quantization::FIELDS_BITS)) {
+                    return nullptr;
+                }
+                if (fields & FIELD_REMOVED) {
+                    changes[entity.entity].components = 0;
+                    changes[entity.entity].entity = entity.entity;
+                    continue;
+                }
+                auto it = assembly->entities.find(entity.entity);
+
+                if (it != assembly->entities.end()) {
+                    entity = it->second;
+                }
+                if (!entity.read(bits, static_cast<std::uint8_t>(fields))) {
+                    return nullptr;
+                }
+                changes[entity.entity] = entity;
+            }
+            // the part is only applied once fully read
+            for (auto &[handle, entity] : changes) {
+                if (entity.components == 0) {
+                    assembly->entities.erase(handle);
+                } else {
+                    assembly->entities[handle] = entity;
+                }
+            }
+            mark_part(*assembly, message.part);
+            if (message.last) {
+                assembly->part_count = message.part + 1;
+            }
+            if (assembly->part_count == 0 || assembly->received != assembly->part_count) {
+                return nullptr;
+            }
+            return complete(message.tick, message.input_tick);
+        }
+
+        /**
+         * @brief Get the last snapshot fully read.
+         *
+         */
+        const Snapshot *latest() const
+        {
+            return history_.latest();
+        }
+
+    private:
+        /**
+         * @brief A snapshot whose parts are being read.
+         *
+         */
+        struct Assembly
+        {
+            std::map<std::uint64_t, EntitySnapshot, EntityLess> entities;
+            std::vector<bool> parts;
+            std::size_t received;
+            std::size_t part_count;
+        };
+
+        static bool newer(std::uint32_t tick, std::uint32_t than)
+        {
+            return static_cast<std::int32_t>(tick - than) > 0;
+        }
+
+        Assembly *find_assembly(const SnapshotMessage &message)
+        {
+            auto it = assemblies_.find(message.tick);
+
+            if (it != assemblies_.end()) {
+                return &it->second;
+            }
+            const Snapshot *baseline = nullptr;
+
+            if (message.baseline != K_NO_BASELINE) {
+                baseline = history_.find(message.baseline);
+                if (!baseline) {
+                    return nullptr;
+                }
+            }
+            Assembly &assembly = assemblies_[message.tick];
+
+            assembly.received = 0;
+            assembly.part_count = 0;
+            if (baseline) {
+                for (const EntitySnapshot &entity : baseline->entities) {
+                    assembly.entities.emplace_hint(assembly.entities.end(), entity.entity, entity);
+                }
+            }
+            return &assembly;
+        }
+
+        static bool has_part(const Assembly &assembly, std::uint16_t part)
+        {
+            return part < assembly.parts.size() && assembly.parts[part];
+        }
+
+        static void mark_part(Assembly &assembly, std::uint16_t part)
+        {
+            if (part >= assembly.parts.size()) {
+                assembly.parts.resize(part + 1, false);
+            }
+            assembly.parts[part] = true;
+            ++assembly.received;
+        }
+
+        const Snapshot *complete(std::uint32_t tick, std::uint32_t input_tick)
+        {
+            Assembly &assembly = assemblies_[tick];
+            Snapshot &snapshot = history_.next();
+
+            snapshot.tick = tick;
+            snapshot.input_tick = input_tick;
+            snapshot.entities.clear();
+            for (auto &[handle, entity] : assembly.entities) {
+                snapshot.entities.push_back(entity);
+            }
+            latest_ = tick;
+            // the snapshots older than the completed one are useless now
+            for (auto it = assemblies_.begin(); it != assemblies_.end();) {
+                it = newer(it->first, tick) ? std::next(it) : assemblies_.erase(it);
+            }
+            return &history_.push();
+        }
+
+        SnapshotHistory history_;
+        std::map<std::uint32_t, Assembly> assemblies_;
+        std::optional<std::uint32_t> latest_;
+    };
+}
@@ -0,0 +1,456 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <limits>
+
+#include "net_common.h"
+#include "net_packet.h"
+
+#if defined(__linux__) && !defined(NET_NO_BATCHED_IO)
+#define NET_BATCHED_IO
+#include <sys/socket.h>
+#endif
+
+namespace net
+{
+    /**
+     * @brief The maximum number of datagrams received or sent
+     * by a single system call.
+     *
+     */
+    constexpr std::size_t K_BATCH_SIZE = 32;
+    /**
+     * @brief The maximum number of batches received when the
+     * socket is readable, before letting the other handlers of
+     * the io_context run.
+     *
+     */
+    constexpr std::size_t K_MAX_BATCHES = 8;
+
+    /**
+     * @brief A UDP socket exchanging pooled packets, shared by
+     * UdpServer and UdpClient. The datagrams are received by the
+     * thread running the io_context and pushed to a bounded queue,
+     * drained by poll(). The sent datagrams are copied to a queue
+     * and sent from the io_context thread.
+     * When the queues are full, or the pool is empty, datagrams
+     * are dropped and counted instead of piling up.
+     *
+     * On Linux, once the socket is readable every pending datagram
+     * is drained with recvmmsg(), and the queued datagrams are sent
+     * with sendmmsg(), a batch per system call (define
+     * NET_NO_BATCHED_IO to disable it). Elsewhere each datagram
+     * is received and sent by its own asio operation.
+     *
+     */
+    class PacketSocket
+    {
+    public:
+        /**
+         * @brief Open a socket bound to an endpoint.
+         *
+         */
+        PacketSocket(boost::asio::io_context &io_context, const boost::asio::ip::udp::endpoint &endpoint, std::size_t queue_size)
+            : socket_(io_context, endpoint),
+              // every queued packet, plus as many for the sends
+              pool_(2 * queue_size),
+              received_(queue_size),
+              outgoing_(queue_size),
+              stop_flag_(false),
+              flush_pending_(false),
+              waiting_write_(false),
+              received_count_(0),
+              sent_count_(0),
+              dropped_queue_full_(0),
+              dropped_no_buffer_(0),
+              dropped_truncated_(0),
+              send_errors_(0)
+        {
+            start_receive();
+        }
+
+        /**
+         * @brief Open a socket bound to any port.
+         *
+         */
+        PacketSocket(boost::asio::io_context &io_context, const boost::asio::ip::udp &protocol, std::size_t queue_size)
+            : socket_(io_context, protocol),
+              pool_(2 * queue_size),
+              received_(queue_size),
+              outgoing_(queue_size),
+              stop_flag_(false),
+              flush_pending_(false),
+              waiting_write_(false),
+              received_count_(0),
+              sent_count_(0),
+              dropped_queue_full_(0),
+              dropped_no_buffer_(0),
+              dropped_truncated_(0),
+              send_errors_(0)
+        {
+            start_receive();
+        }
+
+        ~PacketSocket()
+        {
+            // the io_context isn't running anymore, unlike in stop()
+            if (!stop_flag_.exchange(true)) {
+                boost::system::error_code ec;
+
+                socket_.close(ec);
+            }
+        }
+
+        /**
+         * @brief Close the socket, cancelling its pending
+         * operations. It can be called from any thread: the
+         * socket isn't thread safe, so it is closed by the thread
+         * running the io_context, which returns once the
+         * cancelled handlers ran.
+         *
+         */
+        void stop()
+        {
+            if (!stop_flag_.exchange(true)) {
+                boost::asio::post(socket_.get_executor(), [this]() {
+                    boost::system::error_code ec;
+
+                    socket_.close(ec);
+                });
+            }
+        }
+
+        boost::asio::ip::udp::endpoint local_endpoint() const
+        {
+            return socket_.local_endpoint();
+        }
+
+        /**
+         * @brief Send a datagram. The data is copied, so it can
+         * be reused as soon as the call returns. It can be called
+         * from any thread.
+         *
+         */
+        void send(const void *data, std::size_t size, const boost::asio::ip::udp::endpoint &endpoint)
+        {
+            Packet *packet = (size <= K_BUFFER_SIZE) ? acquire_packet() : nullptr;
+
+            if (!packet) {
+                return;
+            }
+            std::memcpy(packet->data.data(), data, size);
+            packet->size = size;
+            send_packet(packet, endpoint);
+        }
+
+        /**
+         * @brief Take a packet from the pool, e.g. to write a
+         * message into it (see MessageWriter) and send it with
+         * send_packet() without any copy.
+         *
+         * @return Packet* The packet, nullptr (counted as a drop)
+         * if every packet is in use.
+         */
+        Packet *acquire_packet()
+        {
+            Packet *packet = pool_.acquire();
+
+            if (!packet) {
+                ++dropped_no_buffer_;
+            }
+            return packet;
+        }
+
+        /**
+         * @brief Give back a packet taken with acquire_packet()
+         * and not sent.
+         *
+         */
+        void release_packet(Packet *packet)
+        {
+            pool_.release(packet);
+        }
+
+        /**
+         * @brief Send a packet taken with acquire_packet(). The
+         * packet goes back to the pool once sent. It can be called
+         * from any thread.
+         *
+         */
+        void send_packet(Packet *packet, const boost::asio::ip::udp::endpoint &endpoint)
+        {
+            packet->endpoint = endpoint;
+            if (!outgoing_.try_push(packet)) {
+                ++dropped_queue_full_;
+                pool_.release(packet);
+                return;
+            }
+            // a single flush is posted for all the sends queued in the meantime
+            if (!flush_pending_.exchange(true)) {
+                boost::asio::post(socket_.get_executor(), [this]() { flush_sends(); });
+            }
+        }
+
+        /**
+         * @brief Call a handler on the received datagrams, oldest
+         * first. The packet given to the handler is reused once
+         * it returns.
+         *
+         * @param handler The handler, taking a const Packet reference.
+         * @param max The maximum number of datagrams handled.
+         * @return std::size_t The number of datagrams handled.
+         */
+        template <typename Handler>
+        std::size_t poll(Handler &&handler, std::size_t max = std::numeric_limits<std::size_t>::max())
+        {
+            std::size_t count = 0;
+            Packet *packet = nullptr;
+
+            while (count < max && received_.try_pop(packet)) {
+                handler(static_cast<const Packet &>(*packet));
+                pool_.release(packet);
+                ++count;
+            }
+            return count;
+        }
+
+        SocketStats get_stats() const
+        {
+            return SocketStats{received_count_, sent_count_, dropped_queue_full_, dropped_no_buffer_, dropped_truncated_, send_errors_};
+        }
+
+    private:
+        void push_received(Packet *packet)
+        {
+            ++received_count_;
+            if (!received_.try_push(packet)) {
+                ++dropped_queue_full_;
+                pool_.release(packet);
+            }
+        }
+
+#ifdef NET_BATCHED_IO
+        void start_receive()
+        {
+            socket_.async_wait(boost::asio::ip::udp::socket::wait_read, [this](boost::system::error_code ec)
+            {
+                if (ec || stop_flag_) {
+                    return;
+                }
+                for (std::size_t i = 0; i < K_MAX_BATCHES && receive_batch() == K_BATCH_SIZE; i++) {
+                }
+                start_receive();
+            });
+        }
+
+        std::size_t receive_batch()
+        {
+            std::array<mmsghdr, K_BATCH_SIZE> messages;
+            std::array<iovec, K_BATCH_SIZE> iovecs;
+            std::array<Packet *, K_BATCH_SIZE> packets;
+            std::size_t count = 0;
+
+            while (count < K_BATCH_SIZE && (packets[count] = pool_.acquire())) {
+                Packet &packet = *packets[count];
+
+                iovecs[count] = iovec{packet.data.data(), packet.data.size()};
+                messages[count] = mmsghdr{};
+                messages[count].msg_hdr.msg_name = packet.endpoint.data();
+                messages[count].msg_hdr.msg_namelen = packet.endpoint.capacity();
+                messages[count].msg_hdr.msg_iov = &iovecs[count];
+                messages[count].msg_hdr.msg_iovlen = 1;
+                ++count;
+            }
+            if (count == 0) {
+                // no packet left, drain the socket anyway so it doesn't fill up
+                if (::recv(socket_.native_handle(), drop_buffer_.data(), drop_buffer_.size(), MSG_DONTWAIT) < 0) {
+                    return 0;
+                }
+                ++dropped_no_buffer_;
+                return K_BATCH_SIZE;
+            }
+            int received = ::recvmmsg(socket_.native_handle(), messages.data(), count, MSG_DONTWAIT, nullptr);
+
+            received = std::max(received, 0);
+            for (int i = 0; i < received; i++) {
+                // the end of a datagram larger than the packet is lost, don't read the rest
+                if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                    ++dropped_truncated_;
+                    pool_.release(packets[i]);
+                    continue;
+                }
+                packets[i]->endpoint.resize(messages[i].msg_hdr.msg_namelen);
+                packets[i]->size = messages[i].msg_len;
+                push_received(packets[i]);
+            }
+            for (std::size_t i = received; i < count; i++) {
+                pool_.release(packets[i]);
+            }
+            return received;
+        }
+
+        void flush_sends()
+        {
+            std::array<mmsghdr, K_BATCH_SIZE> messages;
+            std::array<iovec, K_BATCH_SIZE> iovecs;
+            Packet *packet = nullptr;
+
+            flush_pending_ = false;
+            while (!stop_flag_) {
+                while (unsent_.size() < K_BATCH_SIZE && outgoing_.try_pop(packet)) {
+                    unsent_.push_back(packet);
+                }
+                if (unsent_.empty()) {
+                    return;
+                }
+                std::size_t count = std::min(unsent_.size(), K_BATCH_SIZE);
+
+                for (std::size_t i = 0; i < count; i++) {
+                    iovecs[i] = iovec{unsent_[i]->data.data(), unsent_[i]->size};
+                    messages[i] = mmsghdr{};
+                    messages[i].msg_hdr.msg_name = unsent_[i]->endpoint.data();
+                    messages[i].msg_hdr.msg_namelen = unsent_[i]->endpoint.size();
+                    messages[i].msg_hdr.msg_iov = &iovecs[i];
+                    messages[i].msg_hdr.msg_iovlen = 1;
+                }
+                int sent = ::sendmmsg(socket_.native_handle(), messages.data(), count, MSG_DONTWAIT);
+
+                if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    // the socket buffer is full, resume once it is writable
+                    if (!waiting_write_) {
+                        waiting_write_ = true;
+                        socket_.async_wait(boost::asio::ip::udp::socket::wait_write, [this](boost::system::error_code ec)
+                        {
+                            waiting_write_ = false;
+                            if (!ec) {
+                                flush_sends();
+                            }
+                        });
+                    }
+                    return;
+                }
+                if (sent < 0) {
+                    // the first datagram is refused (e.g. unreachable), skip it
+                    ++send_errors_;
+                    sent = 1;
+                } else {
+                    sent_count_ += sent;
+                }
+                for (int i = 0; i < sent; i++) {
+                    pool_.release(unsent_.front());
+                    unsent_.pop_front();
+                }
+            }
+        }
+#else
+        void start_receive()
+        {
+            Packet *packet = pool_.acquire();
+
+            if (!packet) {
+                // no packet left, drain the socket anyway so it doesn't fill up
+                socket_.async_receive_from(
+                    boost::asio::buffer(drop_buffer_), drop_endpoint_,
+                    [this](boost::system::error_code ec, std::size_t /*bytes_received*/)
+                    {
+                        if (!ec) {
+                            ++dropped_no_buffer_;
+                        }
+                        if (!stop_flag_) {
+                            start_receive();
+                        }
+                    });
+                return;
+            }
+            socket_.async_receive_from(
+                boost::asio::buffer(packet->data), packet->endpoint,
+                [this, packet](boost::system::error_code ec, std::size_t bytes_received)
+                {
+                    if (ec) {
+                        pool_.release(packet);
+                    } else {
+                        packet->size = bytes_received;
+                        push_received(packet);
+                    }
+                    if (!stop_flag_) {
+                        start_receive();
+                    }
+                });
+        }
+
+        void flush_sends()
+        {
+            Packet *packet = nullptr;
+
+            flush_pending_ = false;
+            while (outgoing_.try_pop(packet)) {
+                socket_.async_send_to(
+                    boost::asio::buffer(packet->data.data(), packet->size), packet->endpoint,
+                    [this, packet](boost::system::error_code ec, std::size_t /*bytes_sent*/)
+                    {
+                        if (ec) {
+                            ++send_errors_;
+                        } else {
+                            ++sent_count_;
+                        }
+                        pool_.release(packet);
+                    });
+            }
+        }
+#endif
+
+        boost::asio::ip::udp::socket socket_;
+        PacketPool pool_;
+        BoundedQueue<Packet *> received_;
+        BoundedQueue<Packet *> outgoing_;
+        /**
+         * @brief The datagrams popped from outgoing_ and not
+         * sent yet, only used by the io_context thread.
+         *
+         */
+        std::deque<Packet *> unsent_;
+        std::array<char, K_BUFFER_SIZE> drop_buffer_;
+        boost::asio::ip::udp::endpoint drop_endpoint_;
+        std::atomic<bool> stop_flag_;
+        std::atomic<bool> flush_pending_;
+        bool waiting_write_;
+        std::atomic<std::uint64_t> received_count_;
+        std::atomic<std::uint64_t> sent_count_;
+        std::atomic<std::uint64_t> dropped_queue_full_;
+        std::atomic<std::uint64_t> dropped_no_buffer_;
+        std::atomic<std::uint64_t> dropped_truncated_;
+        std::atomic<std::uint64_t> send_errors_;
+    };
+
+    /**
+     * @brief Stops a socket (e.g. a UdpServer or UdpClient) and
+     * joins the thread running its io_context when leaving the
+     * scope, exception or not: the socket is closed by the io
+     * thread and a joinable thread terminates the program once
+     * destroyed.
+     *
+     * e.g:
+     * ```cpp
+     * std::thread io_thread([&io_context]() { io_context.run(); });
+     * net::IoThreadGuard<net::UdpClient> io_thread_guard{client, io_thread};
+     * ```
+     *
+     */
+    template <typename Socket>
+    struct IoThreadGuard
+    {
+        Socket &socket;
+        std::thread &thread;
+
+        ~IoThreadGuard()
+        {
+            socket.stop();
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    };
+}
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "aabb_overlap.hpp"
+
+/**
+ * @brief The number of boxes tested by each measure.
+ *
+ */
+#define BENCH_TESTS 50000000
+
+/**
+ * @brief The scalar loop overlap_batch() replaces.
+ *
+ */
+static std::size_t overlap_scalar(float min_x, float min_y, float max_x, float max_y, const AabbBatch &others, std::size_t count, std::uint32_t *hits)
+{
+    std::size_t found = 0;
+
+    for (std::size_t i = 0; i < count; i++) {
+        if (min_x <= others.max_x[i] && others.min_x[i] <= max_x &&
+            min_y <= others.max_y[i] && others.min_y[i] <= max_y) {
+            hits[found++] = static_cast<std::uint32_t>(i);
+        }
+    }
+    return found;
+}
+
+template <typename Function>
+static double measure(Function &&overlap, const std::vector<float> &boxes, std::size_t count, std::size_t &found)
+{
+    AabbBatch batch{boxes.data(), boxes.data() + count, boxes.data() + 2 * count, boxes.data() + 3 * count};
+    std::vector<std::uint32_t> hits(count, 0);
+    std::size_t queries = BENCH_TESTS / count;
+    auto start = std::chrono::steady_clock::now();
+
+    found = 0;
+    for (std::size_t q = 0; q < queries; q++) {
+        std::size_t box = q % count;
+
+        found += overlap(batch.min_x[box], batch.min_y[box], batch.max_x[box], batch.max_y[box], batch, count, hits.data());
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / static_cast<double>(queries * count);
+}
+
+int main()
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(0.0f, 1000.0f);
+    std::uniform_real_distribution<float> size(8.0f, 64.0f);
+
+    std::cout << "overlap_batch, " << AABB_OVERLAP_WIDTH << " boxes at once" << std::endl;
+    for (std::size_t count : {7, 16, 61, 256, 1021, 4096}) {
+        // min_x, min_y, max_x and max_y arrays of count boxes
+        std::vector<float> boxes(4 * count, 0.0f);
+        std::size_t found_scalar = 0;
+        std::size_t found_batch = 0;
+
+        for (std::size_t i = 0; i < count; i++) {
+            boxes[i] = position(rng);
+            boxes[count + i] = position(rng);
+            boxes[2 * count + i] = boxes[i] + size(rng);
+            boxes[3 * count + i] = boxes[count + i] + size(rng);
+        }
+        double scalar = measure(overlap_scalar, boxes, count, found_scalar);
+        double batch = measure(overlap_batch, boxes, count, found_batch);
+
+        std::cout << "  " << count << " boxes: scalar " << scalar << " ns/box, overlap_batch "
+                  << batch << " ns/box (x" << scalar / batch << ")"
+                  << ((found_scalar != found_batch) ? " MISMATCH" : "") << std::endl;
+    }
+    return 0;
+}
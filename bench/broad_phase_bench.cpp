@@ -0,0 +1,102 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "broad_phase.hpp"
+
+/**
+ * @brief The layers of the benchmark: the enemies collide with
+ * the player and the player bullets, nothing else collides.
+ *
+ */
+#define LAYER_PLAYER 1u
+#define LAYER_ENEMY 2u
+#define LAYER_BULLET 4u
+
+/**
+ * @brief The loop the sweep and prune replaced, every collider
+ * tested against every other.
+ *
+ */
+static void all_pairs(const std::vector<BroadPhaseProxy> &proxies, std::vector<std::pair<std::size_t, std::size_t>> &pairs)
+{
+    pairs.clear();
+    for (std::size_t i = 0; i < proxies.size(); i++) {
+        for (std::size_t j = i + 1; j < proxies.size(); j++) {
+            const BroadPhaseProxy &lhs = proxies[i];
+            const BroadPhaseProxy &rhs = proxies[j];
+
+            if (lhs.min_x <= rhs.max_x && rhs.min_x <= lhs.max_x &&
+                lhs.min_y <= rhs.max_y && rhs.min_y <= lhs.max_y && doesInteract(lhs, rhs)) {
+                pairs.emplace_back(lhs.entity, rhs.entity);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Colliders spread over a 1920x1080 screen, a tenth of
+ * enemies, a player and bullets for the rest.
+ *
+ */
+static std::vector<BroadPhaseProxy> make_colliders(std::size_t count, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> x(0.0f, 1920.0f);
+    std::uniform_real_distribution<float> y(0.0f, 1080.0f);
+    std::uniform_real_distribution<float> size(4.0f, 32.0f);
+    std::vector<BroadPhaseProxy> proxies;
+
+    for (std::size_t i = 0; i < count; i++) {
+        std::uint32_t layer = (i == 0) ? LAYER_PLAYER : ((i % 10 == 0) ? LAYER_ENEMY : LAYER_BULLET);
+        std::uint32_t mask = (layer == LAYER_ENEMY) ? (LAYER_PLAYER | LAYER_BULLET) : LAYER_ENEMY;
+        float min_x = x(rng);
+        float min_y = y(rng);
+
+        proxies.push_back(BroadPhaseProxy{i, min_x, min_y, min_x + size(rng), min_y + size(rng), layer, mask});
+    }
+    return proxies;
+}
+
+/**
+ * @brief Time a broad-phase, on a copy of the colliders since
+ * sweep_and_prune() sorts them, as the collision system does.
+ *
+ */
+template <typename Function>
+static double measure(Function &&broad_phase, const std::vector<BroadPhaseProxy> &colliders, std::size_t runs, std::size_t &found)
+{
+    std::vector<BroadPhaseProxy> proxies;
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    std::chrono::duration<double, std::milli> elapsed(0.0);
+
+    for (std::size_t run = 0; run < runs; run++) {
+        proxies = colliders;
+        auto start = std::chrono::steady_clock::now();
+
+        broad_phase(proxies, pairs);
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+    found = pairs.size();
+    return elapsed.count() / static_cast<double>(runs);
+}
+
+int main()
+{
+    std::mt19937 rng(42);
+
+    std::cout << "colliders\tpairs\tsweep_and_prune (ms)\tall pairs (ms)" << std::endl;
+    for (std::size_t count : {100, 500, 1000, 2000, 5000, 10000, 20000}) {
+        std::vector<BroadPhaseProxy> colliders = make_colliders(count, rng);
+        std::size_t runs = (count <= 1000) ? 200 : 20;
+        std::size_t found = 0;
+        std::size_t found_all = 0;
+        double sweep = measure(sweep_and_prune, colliders, runs, found);
+
+        // the all-pairs loop takes about a second at 20k colliders
+        double all = measure(all_pairs, colliders, (count <= 1000) ? runs : 2, found_all);
+
+        std::cout << count << "\t\t" << found << "\t" << sweep << "\t\t" << all
+                  << ((found_all != found) ? " MISMATCH" : "") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <vector>
+#include "net_socket.h"
+
+using boost::asio::ip::udp;
+
+/**
+ * @brief The number of datagrams sent by each measure.
+ *
+ */
+#define BENCH_PACKETS 200000
+/**
+ * @brief The maximum number of datagrams sent but not received
+ * yet, so the measure isn't made of drops: the kernel drops the
+ * datagrams past the socket receive buffer, about 200 KiB.
+ *
+ */
+#define BENCH_WINDOW 128
+#define BENCH_QUEUE_SIZE 4096
+
+/**
+ * @brief Send datagrams of a size from a socket to another through
+ * the loopback, both served by one io thread, and drain them as a
+ * simulation thread would.
+ *
+ */
+static void measure(std::size_t size)
+{
+    boost::asio::io_context io_context;
+    net::PacketSocket receiver(io_context, udp::endpoint(boost::asio::ip::address_v4::loopback(), 0), BENCH_QUEUE_SIZE);
+    net::PacketSocket sender(io_context, udp::v4(), BENCH_QUEUE_SIZE);
+    auto work = boost::asio::make_work_guard(io_context);
+    std::thread io_thread([&io_context]() { io_context.run(); });
+    udp::endpoint endpoint = receiver.local_endpoint();
+    std::vector<std::uint8_t> payload(size, 0x2a);
+    std::uint64_t sent = 0;
+    std::uint64_t received = 0;
+    std::uint64_t bytes = 0;
+    std::clock_t cpu_start = std::clock();
+    auto start = std::chrono::steady_clock::now();
+    auto last_received = start;
+
+    while (received < BENCH_PACKETS) {
+        while (sent < BENCH_PACKETS && sent - received < BENCH_WINDOW) {
+            sender.send(payload.data(), payload.size(), endpoint);
+            ++sent;
+        }
+        std::size_t count = receiver.poll([&bytes](const net::Packet &packet) { bytes += packet.size; });
+
+        received += count;
+        if (count > 0) {
+            last_received = std::chrono::steady_clock::now();
+        } else if (std::chrono::steady_clock::now() - last_received > std::chrono::milliseconds(100)) {
+            // the window is made of lost datagrams, don't wait for them anymore
+            if (sent == BENCH_PACKETS)
+                break;
+            received = sent;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    std::chrono::duration<double> elapsed = last_received - start;
+    double cpu = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    net::SocketStats receiver_stats = receiver.get_stats();
+    net::SocketStats sender_stats = sender.get_stats();
+    std::uint64_t delivered = receiver_stats.received;
+
+    receiver.stop();
+    sender.stop();
+    work.reset();
+    io_thread.join();
+    std::cout << "  " << size << " bytes: " << static_cast<std::uint64_t>(delivered / elapsed.count()) << " packets/s, "
+              << bytes / elapsed.count() / (1024.0 * 1024.0) << " MiB/s, "
+              << cpu * 1e6 / static_cast<double>(delivered) << " us CPU/packet, "
+              << BENCH_PACKETS - delivered << " lost ("
+              << sender_stats.dropped_no_buffer + sender_stats.dropped_queue_full + sender_stats.send_errors << " on send, "
+              << receiver_stats.dropped_no_buffer + receiver_stats.dropped_queue_full + receiver_stats.dropped_truncated
+              << " on receive)" << std::endl;
+}
+
+int main()
+{
+#ifdef NET_BATCHED_IO
+    std::cout << "loopback, recvmmsg/sendmmsg batches of " << net::K_BATCH_SIZE << std::endl;
+#else
+    std::cout << "loopback, a system call per datagram" << std::endl;
+#endif
+    std::size_t const sizes[] = {16, 64, 256, net::K_BUFFER_SIZE};
+
+    for (std::size_t size : sizes)
+        measure(size);
+    return 0;
+}
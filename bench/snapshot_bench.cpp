@@ -0,0 +1,100 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include "net_snapshot.h"
+
+/**
+ * @brief The number of ticks encoded by each measure.
+ *
+ */
+#define BENCH_TICKS 300
+/**
+ * @brief The share of the entities moving each tick.
+ *
+ */
+#define BENCH_MOVING 0.05f
+
+/**
+ * @brief Entities spread over the playfield, a third of them
+ * without velocity nor health, as the obstacles.
+ *
+ */
+static net::Snapshot make_snapshot(std::size_t count, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> x(0.0f, 1920.0f);
+    std::uniform_real_distribution<float> y(0.0f, 1080.0f);
+    net::Snapshot snapshot{0, {}};
+
+    for (std::uint32_t i = 0; i < count; i++) {
+        net::EntitySnapshot entity{};
+
+        entity.entity = i;
+        entity.components = net::REPLICATED_TRANSFORM | net::REPLICATED_SPRITE;
+        entity.x = x(rng);
+        entity.y = y(rng);
+        entity.scale_x = 3.0f;
+        entity.scale_y = 3.0f;
+        entity.texture_size = 5;
+        std::memcpy(entity.texture, "enemy", 5);
+        if (i % 3 != 0) {
+            entity.components |= net::REPLICATED_RIGID_BODY | net::REPLICATED_MORTAL;
+            entity.velocity_x = -120.0f;
+            entity.health = 3;
+        }
+        snapshot.entities.push_back(entity);
+    }
+    return snapshot;
+}
+
+/**
+ * @brief Encode a tick per snapshot, each one delta-encoded
+ * against the previous one as if every snapshot was acknowledged
+ * right away, and report the bytes and the time per tick.
+ *
+ */
+static void measure(std::size_t count)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> pick(0, count - 1);
+    std::uniform_real_distribution<float> step(-4.0f, 4.0f);
+    net::SnapshotHistory history;
+    net::Snapshot snapshot = make_snapshot(count, rng);
+    net::Packet packet;
+    std::size_t parts = 0;
+    auto acquire = [&packet]() { return &packet; };
+    auto send = [&parts](net::Packet *) { ++parts; };
+    net::MessageHeader header{net::PROTOCOL_VERSION, net::MESSAGE_SNAPSHOT, 0, 0, 0, 0};
+    std::size_t full = net::encode_snapshot(snapshot, nullptr, net::K_NO_INPUT, header, acquire, send);
+    std::size_t full_parts = parts;
+    std::size_t bytes = 0;
+    std::chrono::duration<double, std::micro> elapsed(0.0);
+
+    parts = 0;
+    history.push(snapshot);
+    for (std::uint32_t tick = 1; tick <= BENCH_TICKS; tick++) {
+        snapshot.tick = tick;
+        for (std::size_t i = 0; i < static_cast<std::size_t>(count * BENCH_MOVING); i++) {
+            net::EntitySnapshot &entity = snapshot.entities[pick(rng)];
+
+            entity.x += step(rng);
+            entity.y += step(rng);
+        }
+        auto start = std::chrono::steady_clock::now();
+
+        bytes += net::encode_snapshot(snapshot, history.latest(), tick, header, acquire, send);
+        elapsed += std::chrono::steady_clock::now() - start;
+        history.push(snapshot);
+    }
+    std::cout << "  " << count << " entities: full " << full / 1024.0 << " KiB (" << full_parts << " datagrams), delta "
+              << bytes / 1024.0 / BENCH_TICKS << " KiB/tick (" << static_cast<double>(parts) / BENCH_TICKS
+              << " datagrams), encoded in " << elapsed.count() / BENCH_TICKS << " us/tick" << std::endl;
+}
+
+int main()
+{
+    std::cout << "snapshots, " << BENCH_MOVING * 100.0f << "% of the entities moving each tick" << std::endl;
+    measure(1000);
+    measure(10000);
+    return 0;
+}
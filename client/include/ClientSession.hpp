@@ -0,0 +1,91 @@
+#ifndef CLIENT_SESSION_HPP
+#define CLIENT_SESSION_HPP
+
+#include <cstdint>
+#include <optional>
+// the engine first: net_client.h opens the net namespace, whose Connection
+// clashes with the one of the EventManager
+#include "net_prediction.h"
+#include "net_replication.h"
+#include "net_client.h"
+#include "net_channel.h"
+
+/**
+ * @brief The connection of a client to its room. Until the server
+ * spawns the player of the client, a JoinMessage is sent every
+ * tick, the server only answering to the endpoints it received
+ * from. Then the player is predicted from the inputs of each tick,
+ * which are sent to the server, and the snapshots received are
+ * applied, reconciled with the prediction and acknowledged.
+ *
+ * e.g:
+ * ```cpp
+ * ClientSession session(client);
+ *
+ * while (r.get_timestep().consume_tick())
+ * {
+ *     session.tick(r, read_input(tick++));
+ *     r.run_systems();
+ * }
+ * session.receive(r);
+ * session.flush();
+ * ```
+ *
+ */
+class ClientSession
+{
+public:
+    explicit ClientSession(net::UdpClient &client);
+    ~ClientSession();
+
+    ClientSession(ClientSession const &) = delete;
+    ClientSession &operator=(ClientSession const &) = delete;
+
+    /**
+     * @brief Send the input of a tick, before the tick is run.
+     * Once the player is replicated it is predicted and its input
+     * sent, until then a JoinMessage is sent instead.
+     *
+     * @param r The registry of the client.
+     * @param input The keys held during the tick.
+     */
+    void tick(Registry &r, net::InputMessage const &input);
+    /**
+     * @brief Handle the datagrams received from the server.
+     *
+     * @param r The registry of the client.
+     */
+    void receive(Registry &r);
+    /**
+     * @brief Send the reliable acks that didn't fit in a
+     * datagram sent by tick() or receive().
+     *
+     */
+    void flush();
+
+    /**
+     * @brief Get the local entity of the player, nullptr until
+     * it is spawned and replicated.
+     *
+     */
+    Entity const *get_player() const;
+
+private:
+    void handle(Registry &r, net::Packet const &packet);
+    template <typename Message>
+    void send(net::messageType type, Message const &message);
+
+    net::UdpClient &_client;
+    net::Connection _connection;
+    net::SnapshotDecoder _decoder;
+    net::SnapshotApplier _applier;
+    net::Prediction _prediction;
+    /**
+     * @brief The handle of the player on the server, known
+     * once it is spawned.
+     *
+     */
+    std::optional<std::uint64_t> _server_player;
+};
+
+#endif /* CLIENT_SESSION_HPP */
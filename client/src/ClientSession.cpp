@@ -0,0 +1,94 @@
+#include "ClientSession.hpp"
+
+ClientSession::ClientSession(net::UdpClient &client)
+    : _client(client),
+      _connection(),
+      _decoder(),
+      _applier(),
+      _prediction(),
+      _server_player()
+{
+}
+
+ClientSession::~ClientSession()
+{
+}
+
+template <typename Message>
+void ClientSession::send(net::messageType type, Message const &message)
+{
+    net::Packet *packet = _client.acquire_packet();
+
+    if (!packet)
+        return;
+    net::MessageWriter writer(*packet);
+
+    message.write(writer);
+    if (writer.finish(_connection.make_header(type)))
+    {
+        _connection.stamp(*packet);
+        _client.send_packet(packet);
+    }
+    else
+    {
+        _client.release_packet(packet);
+    }
+}
+
+void ClientSession::tick(Registry &r, net::InputMessage const &input)
+{
+    Entity const *player = get_player();
+
+    // the acceleration isn't replicated, only the predicted inputs are sent,
+    // and the server only needs to hear from the client until then
+    if (!player)
+    {
+        send(net::MESSAGE_JOIN, net::JoinMessage{});
+        return;
+    }
+    _prediction.predict(r, *player, input);
+    send(net::MESSAGE_INPUT, input);
+}
+
+void ClientSession::receive(Registry &r)
+{
+    _client.poll([this, &r](net::Packet const &packet) { handle(r, packet); });
+}
+
+void ClientSession::flush()
+{
+    _connection.flush([this]() { return _client.acquire_packet(); },
+                      [this](net::Packet *packet) { _client.send_packet(packet); });
+}
+
+Entity const *ClientSession::get_player() const
+{
+    return _server_player ? _applier.find(*_server_player) : nullptr;
+}
+
+void ClientSession::handle(Registry &r, net::Packet const &packet)
+{
+    // the reliable messages are delivered even with an outdated payload
+    net::receiveStatus status = _connection.receive(packet, [this](net::MessageReader &reader)
+    {
+        net::SpawnMessage spawn;
+
+        if ((reader.header().type == net::MESSAGE_SPAWN) && spawn.read(reader) && (spawn.prefab == net::PREFAB_LOCAL_PLAYER))
+        {
+            _server_player = spawn.entity;
+            _applier.set_predicted(spawn.entity);
+        }
+    });
+    net::MessageReader reader(packet);
+
+    if ((status != net::RECEIVE_NEW) || (reader.header().type != net::MESSAGE_SNAPSHOT))
+        return;
+    net::Snapshot const *snapshot = _decoder.read(reader);
+
+    if (!snapshot)
+        return;
+    _applier.apply(r, *snapshot);
+    if (Entity const *player = get_player())
+        _prediction.reconcile(r, *player, *snapshot, *_server_player);
+    send(net::MESSAGE_SNAPSHOT_ACK, net::SnapshotAckMessage{snapshot->tick});
+}
@@ -1,7 +1,31 @@
-#include "net_client.h"
+#include <chrono>
+#include "ClientSession.hpp"
+#include "sfml_dict.hpp"
 
 using namespace boost::asio;
 
+/**
+ * @brief The keys sent to the server. They are read held
+ * down every tick, not on key press, so the server moves
+ * the player the way it is predicted.
+ *
+ */
+static const sf::Keyboard::Key sent_keys[] = {
+    sf::Keyboard::Up, sf::Keyboard::Left, sf::Keyboard::Down, sf::Keyboard::Right,
+};
+
+static InputMessage read_input(std::uint32_t tick)
+{
+    InputMessage input{tick, 0, {}};
+
+    for (sf::Keyboard::Key key : sent_keys) {
+        if (sf::Keyboard::isKeyPressed(key) && input.key_count < K_MAX_INPUT_KEYS) {
+            input.keys[input.key_count++] = static_cast<std::uint8_t>(get_keyboard_input_from_sfml(key));
+        }
+    }
+    return input;
+}
+
 int main(int argc, char* argv[])
 {
     try {
@@ -17,22 +41,37 @@ int main(int argc, char* argv[])
         udp::endpoint server_endpoint = *resolver.resolve(udp::v4(), "127.0.0.1", "12345").begin();
 
         net::UdpClient client(io_context, server_endpoint);
-        std::thread([&io_context]() { io_context.run(); }).detach();
+        std::thread io_thread([&io_context]() { io_context.run(); });
+        net::IoThreadGuard<net::UdpClient> io_thread_guard{client, io_thread};
+
+        // the entities are spawned by the server, the local player too
+        Registry r;
+        sf::RenderWindow &window = r.get_system_manager()._window;
+        ClientSession session(client);
+        std::uint32_t tick = 0;
+        auto last_frame = std::chrono::steady_clock::now();
 
-        while (true) {
-          int id, value;
-          std::cin >> id;
-          if (std::cin.eof()) {
-            break;
+        r.setup(false);
+        while (window.isOpen()) {
+          auto now = std::chrono::steady_clock::now();
+          float seconds = std::chrono::duration<float>(now - last_frame).count();
+
+          last_frame = now;
+          r.get_timestep().accumulate(seconds);
+          r.get_interpolation_clock().advance(seconds);
+          while (r.get_timestep().consume_tick()) {
+            session.tick(r, read_input(tick++));
+            r.run_systems();
           }
-          DataPacket data{10, 10};
-          client.send_data(data);
+          session.receive(r);
+          session.flush();
+          window.clear(sf::Color(238, 245, 178));
+          r.run_render_systems();
+          window.display();
         }
-
-        client.stop();
     } catch (std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -16,6 +16,9 @@ Camera::Camera(Registry &r, const CameraState &state) : _r(r), _state(state)
 
 void Camera::emitConfigEvent() const
 {
+    // a headless registry has no window to configure
+    if (_r.is_headless())
+        return;
     _r._event_manager->emit<Events::CameraConfig>(
                         _state, _r._system_manager->_window);
 }
@@ -0,0 +1,3 @@
+#include "ComponentFamily.hpp"
+
+std::atomic<BaseComponentFamily::Family> BaseComponentFamily::family_counter(0);
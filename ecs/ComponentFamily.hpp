@@ -0,0 +1,60 @@
+#ifndef COMPONENT_FAMILY_HPP
+#define COMPONENT_FAMILY_HPP
+
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+
+/**
+ * @brief The maximum number of component types
+ * that can be registered in the game engine.
+ * 
+ */
+inline constexpr std::size_t MAX_COMPONENTS = 64;
+
+/**
+ * @brief The set of component families attached
+ * to an entity.
+ * 
+ */
+using Signature = std::bitset<MAX_COMPONENTS>;
+
+class BaseComponentFamily
+{
+public:
+    typedef std::size_t Family;
+
+protected:
+    /**
+     * @brief The number of component families
+     * already given to component types.
+     * 
+     */
+    static std::atomic<Family> family_counter;
+};
+
+/**
+ * @brief Gives a unique and dense id to each component
+ * type, the same way Event<Derived>::family() does for
+ * events. The id is given the first time it is asked
+ * and never changes afterwards, so it can be used as
+ * an index in flat arrays instead of hashing typeid.
+ * 
+ * @tparam Component The component type.
+ */
+template <typename Component>
+class ComponentFamily : public BaseComponentFamily
+{
+public:
+    /**
+     * @brief The family of the component type.
+     * 
+     */
+    static Family family()
+    {
+        static const Family family = family_counter++;
+        return family;
+    }
+};
+
+#endif /* COMPONENT_FAMILY_HPP */
@@ -0,0 +1,62 @@
+#ifndef COMPONENT_POOL_HPP
+#define COMPONENT_POOL_HPP
+
+#include <vector>
+#include "Entity.hpp"
+#include "SparseArray.hpp"
+
+/**
+ * @brief The type-erased interface of the SparseArray
+ * of a component type, so the component manager can
+ * keep every SparseArray in a single flat array.
+ * 
+ */
+class BaseComponentPool
+{
+public:
+    virtual ~BaseComponentPool() = default;
+
+    /**
+     * @brief Detach the component of this pool type
+     * from a batch of killed entities, in a single pass.
+     * 
+     * @param ids The ids of the entities. The ones without
+     * a component of this pool type are skipped.
+     */
+    virtual void erase_batch(std::vector<std::size_t> const &ids) = 0;
+};
+
+/**
+ * @brief The owner of the SparseArray of a component type.
+ * 
+ * @tparam Component The component type.
+ */
+template <class Component>
+class ComponentPool : public BaseComponentPool
+{
+public:
+    ComponentPool();
+
+    void erase_batch(std::vector<std::size_t> const &ids) override;
+
+    /**
+     * @brief The components of the pool.
+     * 
+     */
+    SparseArray<Component> _components;
+};
+
+template <class Component>
+inline ComponentPool<Component>::ComponentPool()
+    : _components()
+{
+}
+
+template <class Component>
+inline void ComponentPool<Component>::erase_batch(std::vector<std::size_t> const &ids)
+{
+    for (std::size_t id : ids)
+        _components.erase(id);
+}
+
+#endif /* COMPONENT_POOL_HPP */
@@ -2,6 +2,7 @@
 #define ENTITY_HPP
 
 #include <cstddef>
+#include <cstdint>
 
 /**
  * @brief An entity of the game engine.
@@ -9,29 +10,60 @@
  * an id. However a variable number of components
  * can be attached to an entity to gives it
  * behaviors, data, etc...
- * 
+ *
+ * The id is packed with a generation counter in a
+ * single handle. The generation of an id changes
+ * every time the entity is killed, so an outdated
+ * copy of the entity can be told apart from the
+ * entity that reuses its id.
+ *
  */
 class Entity
 {
 public:
+    using handle_type = std::uint64_t;
+    using generation_type = std::uint32_t;
+
     ~Entity();
     operator std::size_t() const;
 
+    /**
+     * @brief Get the generation of the entity id
+     * when the entity was created.
+     *
+     * @return generation_type The generation of the entity.
+     */
+    generation_type get_generation() const;
+    /**
+     * @brief Get the packed id and generation of the
+     * entity, e.g. to send it over the network.
+     *
+     * @return handle_type The handle of the entity.
+     */
+    handle_type get_handle() const;
+
     friend class EntityManager;
 
 private:
-    explicit Entity(std::size_t const &);
+    explicit Entity(std::size_t const &, generation_type const &);
+    explicit Entity(handle_type const &);
 
     /**
-     * @brief The unique id (also called index)
-     * of the entity.
-     * 
+     * @brief The unique id (also called index) of
+     * the entity in the lower 32 bits and the
+     * generation of the id in the upper 32 bits.
+     *
      */
-    std::size_t _id;
+    handle_type _handle;
 };
 
-inline Entity::Entity(std::size_t const &id)
-    : _id(id)
+inline Entity::Entity(std::size_t const &id, generation_type const &generation)
+    : _handle((static_cast<handle_type>(generation) << 32) | static_cast<std::uint32_t>(id))
+{
+}
+
+inline Entity::Entity(handle_type const &handle)
+    : _handle(handle)
 {
 }
 
@@ -41,7 +73,17 @@ inline Entity::~Entity()
 
 inline Entity::operator std::size_t() const
 {
-    return _id;
+    return static_cast<std::size_t>(_handle & 0xFFFFFFFF);
+}
+
+inline Entity::generation_type Entity::get_generation() const
+{
+    return static_cast<generation_type>(_handle >> 32);
+}
+
+inline Entity::handle_type Entity::get_handle() const
+{
+    return _handle;
 }
 
 #endif /* ENTITY_HPP */
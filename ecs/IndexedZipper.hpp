@@ -2,6 +2,7 @@
 #define INDEXED_ZIPPER_HPP
 
 #include "IndexedZipperIterator.hpp"
+#include "ThreadPool.hpp"
 
 namespace containers
 {
@@ -35,14 +36,15 @@ namespace containers
     {
     public:
         using iterator = IndexedZipperIterator<Containers...>;
-        using iterator_tuple = typename iterator::iterator_tuple;
+        using container_tuple = typename iterator::container_tuple;
 
         IndexedZipper(Containers &...cs)
         {
             _size = min_element(cs.size()...);
             _idx = 0;
-            _begin = std::make_tuple(cs.begin()...);
-            _end = std::make_tuple(cs.end()...);
+            _ids = nullptr;
+            _probe = true;
+            _containers = std::make_tuple(&cs...);
         }
 
         /**
@@ -56,9 +58,29 @@ namespace containers
         {
             _size = min_element(cs.size()...);
             _idx = (idx < _size ? idx : _size);
-            _begin = compute_begin(std::index_sequence_for<Containers...>{}, _idx, cs...);
-            _end = std::make_tuple(cs.end()...);
+            _ids = nullptr;
+            _probe = true;
+            _containers = std::make_tuple(&cs...);
+        }
 
+        /**
+         * @brief Construct a new IndexedZipper object driven by
+         * a View. Only the entities of the view are walked
+         * and, as they all have every component attached,
+         * the SparseArray aren't checked.
+         * Warning: the view must require every component
+         * type of the SparseArray.
+         *
+         * @param view The View of the entities.
+         * @param cs The Components SparseArrays.
+         */
+        IndexedZipper(View const &view, Containers &...cs)
+        {
+            _size = view.size();
+            _idx = 0;
+            _ids = view.entities().data();
+            _probe = false;
+            _containers = std::make_tuple(&cs...);
         }
 
         /**
@@ -70,7 +92,7 @@ namespace containers
          */
         iterator begin()
         {
-            return iterator(_begin, _size, _idx);
+            return iterator(_containers, _ids, _probe, _size, _idx);
         }
 
         /**
@@ -82,7 +104,37 @@ namespace containers
          */
         iterator end()
         {
-            return iterator(_end, _size, _size);
+            return iterator(_containers, _ids, _probe, _size, _size);
+        }
+
+        /**
+         * @brief Call a function on every zipped entity, with the
+         * iteration split in chunks run at the same time by the
+         * threads of a pool (see ThreadPool::parallel_for()). The
+         * function takes the values produced by the iterator, and
+         * must only write to the components it is given.
+         *
+         * e.g:
+         * ```cpp
+         * zipper.parallel_each(r.get_thread_pool(), [](std::size_t idx, auto &pos, auto &vel)
+         * {
+         *     pos += vel;
+         * });
+         * ```
+         *
+         * @tparam Function The type of the function.
+         * @param pool The ThreadPool running the chunks.
+         * @param f The function.
+         */
+        template <typename Function>
+        void parallel_each(ThreadPool &pool, Function &&f)
+        {
+            pool.parallel_for(_idx, _size, PARALLEL_GRAIN, [this, &f](std::size_t begin, std::size_t end)
+                              {
+                iterator last(_containers, _ids, _probe, end, end);
+
+                for (iterator it(_containers, _ids, _probe, end, begin); it != last; ++it)
+                    std::apply(f, *it); });
         }
 
     private:
@@ -114,32 +166,14 @@ namespace containers
             return t;
         }
 
-        /**
-         * @brief Compute the begin value
-         * of the Zipper
-         * 
-         * @tparam Is The sequence of index
-         * in the tuple.
-        */
-        template <size_t...  Is>
-        iterator_tuple compute_begin(std::index_sequence<Is...>, const size_t idx, Containers &...cs)
-        {
-            iterator_tuple t = std::make_tuple(cs.begin()...);
-
-            for (int i = 0; i < idx; i++) {
-                (std::get<Is>(t)++, ...);
-            }
-
-            return t;
-        }
-
         /**
          * @brief The maximum size of the SparseArray
          * Zipping. If SparseArray aren't of the same
          * size, it represents the minimum of all to
-         * avoid errors. It don't represents the number
-         * of entities that have all corresponding 
-         * components attached to.
+         * avoid errors. When driven by a View it is
+         * the number of entities of the view.
+         * It don't represents the number of entities that
+         * have all corresponding components attached to.
          * 
          */
         size_t _size;
@@ -150,18 +184,33 @@ namespace containers
          */
         std::size_t _idx;
         /**
-         * @brief A tuple of all SparseArray
-         * legacy begin iterator.
-         * 
+         * @brief The entity indexes of the driving View,
+         * nullptr when the whole entity index space is walked.
+         *
          */
-        iterator_tuple _begin;
+        std::size_t const *_ids;
         /**
-         * @brief A tuple of all SparseArray
-         * legacy end iterator.
-         * 
+         * @brief Indicate if the iterator must check that
+         * each entity has every component attached.
+         *
+         */
+        bool _probe;
+        /**
+         * @brief A tuple of pointers to all the
+         * zipped SparseArray.
+         *
          */
-        iterator_tuple _end;
+        container_tuple _containers;
     };
+
+    /**
+     * @brief Deduce the SparseArray of a IndexedZipper built from
+     * a non-const View, which would otherwise be taken as one
+     * of the zipped containers.
+     *
+     */
+    template <class... Containers>
+    IndexedZipper(View &, Containers &...) -> IndexedZipper<Containers...>;
 }
 
 #endif /* INDEXED_ZIPPER_HPP */
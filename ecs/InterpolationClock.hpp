@@ -0,0 +1,121 @@
+#ifndef INTERPOLATIONCLOCK_HPP
+#define INTERPOLATIONCLOCK_HPP
+
+#include <cmath>
+
+/**
+ * @brief The clock the remote entities are rendered at on a
+ * client. It follows the server time, synchronized on each
+ * received snapshot and advanced by the frame time in between,
+ * and renders a delay behind it: with a couple of snapshots
+ * in the delay, there is always a newer state to interpolate
+ * to (see Component::Interpolated), and the server can send
+ * its snapshots at a lower rate than it simulates.
+ *
+ * e.g:
+ * ```cpp
+ * InterpolationClock &clock = registry.get_interpolation_clock();
+ *
+ * clock.set_delay(0.1f);
+ * clock.sync(snapshot.tick * registry.get_timestep().get_delta_time());
+ * ```
+ *
+ */
+class InterpolationClock
+{
+public:
+    /**
+     * @brief The default delay, in seconds: 2 to 3 snapshots
+     * sent at 20 to 30 Hz.
+     *
+     */
+    static constexpr float DEFAULT_DELAY = 0.1f;
+
+    explicit InterpolationClock(float delay = DEFAULT_DELAY);
+    ~InterpolationClock();
+
+    /**
+     * @brief Get the delay the entities are rendered behind
+     * the server time, in seconds.
+     *
+     */
+    float get_delay() const;
+    /**
+     * @brief Set the delay the entities are rendered behind
+     * the server time, in seconds. A longer delay hides more
+     * lost or late snapshots, at the cost of latency.
+     *
+     */
+    void set_delay(float delay);
+    /**
+     * @brief Advance the estimated server time by the time
+     * elapsed since the last frame.
+     *
+     * @param seconds The elapsed time, in seconds.
+     */
+    void advance(float seconds);
+    /**
+     * @brief Synchronize the estimated server time with the
+     * time of a received snapshot. A late snapshot doesn't
+     * set the clock back, unless the clock drifted by more
+     * than the delay.
+     *
+     * @param server_time The time of the snapshot, in seconds.
+     */
+    void sync(double server_time);
+    /**
+     * @brief Get the time the entities are rendered at, in
+     * seconds of server time.
+     *
+     */
+    double get_render_time() const;
+
+private:
+    /**
+     * @brief The estimated server time, in seconds.
+     *
+     */
+    double _server_time;
+    float _delay;
+    bool _synced;
+};
+
+inline InterpolationClock::InterpolationClock(float delay)
+    : _server_time(0.0),
+      _delay(delay),
+      _synced(false)
+{
+}
+
+inline InterpolationClock::~InterpolationClock()
+{
+}
+
+inline float InterpolationClock::get_delay() const
+{
+    return _delay;
+}
+
+inline void InterpolationClock::set_delay(float delay)
+{
+    _delay = delay;
+}
+
+inline void InterpolationClock::advance(float seconds)
+{
+    _server_time += seconds;
+}
+
+inline void InterpolationClock::sync(double server_time)
+{
+    if (!_synced || std::fabs(server_time - _server_time) > _delay || server_time > _server_time)
+        _server_time = server_time;
+    _synced = true;
+}
+
+inline double InterpolationClock::get_render_time() const
+{
+    return _server_time - _delay;
+}
+
+#endif /* INTERPOLATIONCLOCK_HPP */
@@ -1,10 +1,16 @@
 #ifndef REGISTRY_HPP
 #define REGISTRY_HPP
 
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include "Managers.hpp"
 #include "Prefabs.hpp"
 #include "Systems.hpp"
 #include "Camera.hpp"
+#include "SystemScheduler.hpp"
+#include "Timestep.hpp"
+#include "InterpolationClock.hpp"
 
 /**
  * @brief The core of the game engine. Regroups entities, components, systems and events.
@@ -14,10 +20,55 @@
 class Registry
 {
 public:
-    Registry();
+    /**
+     * @brief Build the game engine.
+     *
+     * @param headless Build it without the window, the
+     * assets and the render systems, e.g. for the server.
+     * It then only runs the simulation, at the tick rate
+     * of get_timestep().
+     */
+    explicit Registry(bool headless = false);
     ~Registry();
 
+    /**
+     * @brief Set up the game (components, systems and
+     * entities), then run it until the window is closed
+     * or stop() is called.
+     *
+     */
     void run();
+    /**
+     * @brief Register the game components and systems
+     * and spawn its first entities.
+     *
+     * @param local_player Spawn the player moved by the
+     * keyboard, false when the players are spawned by a
+     * server for its clients.
+     */
+    void setup(bool local_player = true);
+    /**
+     * @brief Advance the simulation by the time elapsed
+     * since the last update, running every tick that is due
+     * (see get_timestep()).
+     *
+     * @param seconds The elapsed time, in seconds.
+     * @return std::size_t The number of ticks run.
+     */
+    std::size_t update(float seconds);
+    /**
+     * @brief Make run() return at the end of the current
+     * frame (or tick when headless). It can be called from
+     * any thread.
+     *
+     */
+    void stop();
+    /**
+     * @brief Indicate if the game engine was built without
+     * a window.
+     *
+     */
+    bool is_headless() const;
 
     /**
      * @brief Create a brand new entity with no component
@@ -36,7 +87,27 @@ public:
      */
     Entity entity_from_index(std::size_t index);
     /**
-     * @brief Remove an existing entity from the game.
+     * @brief Rebuild an entity from its handle (e.g. received
+     * over the network). Use is_alive() before using it.
+     *
+     * @param handle The handle of the expected entity.
+     * @return Entity The entity corresponding to the handle.
+     */
+    Entity entity_from_handle(Entity::handle_type handle);
+    /**
+     * @brief Indicate if an entity is still in the game, in
+     * constant time. A killed entity is never alive again,
+     * even when its id is reused.
+     *
+     * @param e The entity.
+     * @return true The entity is alive.
+     * @return false The entity was killed or never spawned.
+     */
+    bool is_alive(Entity const &e) const;
+    /**
+     * @brief Remove an existing entity from the game. The
+     * entity is only queued and is removed, with all the
+     * other killed entities, once every system has run.
      *
      * @param entity The entity to remove.
      */
@@ -158,15 +229,38 @@ public:
      *
      * ```
      *
+     * The sparse arrays are resolved once, when the system is added,
+     * so the components types must already be registered.
+     *
+     * If the function takes a View const reference right after the
+     * Registry, it also receives the View of the entities that have
+     * every component type attached (see EntityManager::get_view()).
+     * It can be zipped to only walk these entities. The entities that
+     * have one of the excluded component families attached are left
+     * out of the View.
+     *
+     * A component type the system only reads is declared const, e.g.
+     * `add_system<Component::Transform const, Component::Sprite const>`,
+     * the system still receives a SparseArray of the non-const type.
+     * Systems that only read the same components may then run at the
+     * same time (see SystemScheduler).
+     *
+     * A system added with the SYSTEM_RENDER flag runs once per rendered
+     * frame, with run_render_systems(), the others run once per
+     * simulation tick, with run_systems().
+     *
      * @tparam Components The components types of the sparse array required
      * by the function system.
      * @tparam Function The type of function (free function or lambda) it
      * doesn't need to be defined.
      * @param f The function that will be added to the game engine as
      * system, it can be both lambda or free function.
+     * @param flags The systemFlag of the system.
+     * @param excluded The component families of the entities the
+     * View of the system skips, e.g. the Predicted player.
      */
     template <class... Components, typename Function>
-    void add_system(Function &&f);
+    void add_system(Function &&f, int flags = SYSTEM_DEFAULT, Signature const &excluded = Signature());
     /**
      * @brief Add a function as a new system to the game engine.
      * The function to be added must always return void, take a Registry
@@ -185,20 +279,67 @@ public:
      *
      * ```
      *
+     * The sparse arrays are resolved once, when the system is added,
+     * so the components types must already be registered.
+     *
+     * If the function takes a View const reference right after the
+     * Registry, it also receives the View of the entities that have
+     * every component type attached (see EntityManager::get_view()).
+     * It can be zipped to only walk these entities. The entities that
+     * have one of the excluded component families attached are left
+     * out of the View.
+     *
+     * A component type the system only reads is declared const, e.g.
+     * `add_system<Component::Transform const, Component::Sprite const>`,
+     * the system still receives a SparseArray of the non-const type.
+     * Systems that only read the same components may then run at the
+     * same time (see SystemScheduler).
+     *
+     * A system added with the SYSTEM_RENDER flag runs once per rendered
+     * frame, with run_render_systems(), the others run once per
+     * simulation tick, with run_systems().
+     *
      * @tparam Components The components types of the sparse array required
      * by the function system.
      * @tparam Function The type of function (free function or lambda) it
      * doesn't need to be defined.
      * @param f The function that will be added to the game engine as
      * system, it can be both lambda or free function.
+     * @param flags The systemFlag of the system.
+     * @param excluded The component families of the entities the
+     * View of the system skips, e.g. the Predicted player.
+     */
+    template <class... Components, typename Function>
+    void add_system(Function const &f, int flags = SYSTEM_DEFAULT, Signature const &excluded = Signature());
+    /**
+     * @brief Wrap a system function in a function only taking
+     * the Registry, see add_system().
+     *
      */
     template <class... Components, typename Function>
-    void add_system(Function const &f);
+    std::function<void(Registry &)> make_system(Function &&f, Signature const &excluded);
     /**
-     * @brief Run all the game engine systems.
+     * @brief Run one simulation tick: every system not added
+     * with the SYSTEM_RENDER flag, then remove the entities
+     * killed by them. Systems read the delta time of the tick
+     * from get_timestep().
      *
      */
     void run_systems();
+    /**
+     * @brief Run every system added with the SYSTEM_RENDER flag,
+     * then remove the entities killed by them.
+     *
+     */
+    void run_render_systems();
+    /**
+     * @brief Set the number of worker threads running the
+     * systems along with the main thread. It is 0 by default,
+     * which runs the systems one after the other.
+     *
+     * @param count The number of worker threads.
+     */
+    void set_worker_count(std::size_t count);
 
     /**
      * @brief Add a function as a new receivers to the game engine.
@@ -284,19 +425,50 @@ public:
     ComponentManager &get_component_manager();
 
     /**
-     * @brief Get the system manager object
+     * @brief Get the system manager object. A headless game
+     * engine has no system manager.
      *
      * @return EntityManager& A reference to the system manager.
      */
     SystemManager &get_system_manager();
 
     /**
-     * @brief All the systems registered of the game engine.
-     * At each update the game engine call every systems.
+     * @brief Get the thread pool running the systems, e.g.
+     * to split a system iteration with parallel_each(). It is
+     * replaced by set_worker_count().
+     *
+     * @return ThreadPool& A reference to the thread pool.
+     */
+    ThreadPool &get_thread_pool();
+
+    /**
+     * @brief Get the fixed-timestep clock of the simulation, e.g.
+     * to read the delta time of a tick or the interpolation alpha
+     * of the rendered frame.
+     *
+     * @return Timestep& A reference to the simulation clock.
+     */
+    Timestep &get_timestep();
+    /**
+     * @brief Get the fixed-timestep clock of the simulation.
+     *
+     * @return Timestep const& A reference to the simulation clock.
+     */
+    Timestep const &get_timestep() const;
+    /**
+     * @brief Get the clock the remote entities are rendered
+     * at on a client, e.g. to set the interpolation delay.
      *
+     * @return InterpolationClock& A reference to the render clock.
      */
-    std::vector<std::function<void(Registry &)>> _systems;
-    
+    InterpolationClock &get_interpolation_clock();
+    /**
+     * @brief Get the clock the remote entities are rendered at.
+     *
+     * @return InterpolationClock const& A reference to the render clock.
+     */
+    InterpolationClock const &get_interpolation_clock() const;
+
     /**
      * @brief Handles the creation and the deletion of
      * entities.
@@ -310,8 +482,8 @@ public:
      */
     std::unique_ptr<ComponentManager> _component_manager;
     /**
-     * @brief Handles the registration of systems to the
-     * game engine.
+     * @brief Handles the window and the assets of the game
+     * engine, nullptr when headless.
      *
      */
     std::unique_ptr<SystemManager> _system_manager;
@@ -321,6 +493,33 @@ public:
      *
      */
     std::unique_ptr<EventManager> _event_manager;
+    /**
+     * @brief All the simulation systems registered of the game
+     * engine. At each tick the game engine call every systems.
+     *
+     */
+    std::unique_ptr<SystemScheduler> _system_scheduler;
+    /**
+     * @brief All the render systems registered of the game
+     * engine. At each frame the game engine call every systems.
+     *
+     */
+    std::unique_ptr<SystemScheduler> _render_scheduler;
+    /**
+     * @brief The fixed-timestep clock of the simulation.
+     *
+     */
+    Timestep _timestep;
+    /**
+     * @brief The clock the remote entities are rendered at.
+     *
+     */
+    InterpolationClock _interpolation_clock;
+    /**
+     * @brief Indicate if run() must keep running.
+     *
+     */
+    std::atomic<bool> _running;
     /**
      * @brief The camera of the game engine. It controls
      * where is the center of the screen, the zoom and
@@ -330,43 +529,106 @@ public:
     Camera _camera;
 };
 
-inline void Registry::run()
+inline void Registry::setup(bool local_player)
 {
+    Signature predicted;
+
     _camera.set_center({0.0f, 0.0f});
 
     register_component<Component::Transform>();
+    register_component<Component::PreviousTransform>();
     register_component<Component::RigidBody>();
     register_component<Component::ColliderBox>();
     register_component<Component::Sprite>();
     register_component<Component::Mortal>();
     register_component<Component::Input>();
     register_component<Component::Damage>();
+    register_component<Component::WorldBounds>();
+    register_component<Component::Interpolated>();
+    register_component<Component::Predicted>();
+    predicted.set(ComponentFamily<Component::Predicted>::family());
 
-    add_system<Component::Input>(System::input_system);
-    add_system<Component::Transform, Component::ColliderBox>(System::debug_system);
-    add_system<Component::Transform, Component::RigidBody>(System::movement_system);
-    add_system<Component::RigidBody>(System::physics_system);
-    add_system<Component::Transform, Component::ColliderBox>(System::collision_system);
-    add_system<Component::Mortal>(System::kill_system);
-    add_system<Component::Transform, Component::Sprite>(System::draw_system);
+    // the predicted player is only moved by its Prediction, from the keys it sends
+    if (!is_headless())
+    {
+        add_system<Component::Input>(System::input_system, SYSTEM_RENDER | SYSTEM_MAIN_THREAD | SYSTEM_EXCLUSIVE, predicted);
+        add_system<Component::Transform const, Component::PreviousTransform>(System::previous_transform_system, SYSTEM_DEFAULT, predicted);
+    }
+    add_system<Component::Transform, Component::RigidBody>(System::movement_system, SYSTEM_DEFAULT, predicted);
+    add_system<Component::RigidBody>(System::physics_system, SYSTEM_DEFAULT, predicted);
+    add_system<Component::Transform const, Component::ColliderBox const, Component::WorldBounds>(System::bounds_system);
+    add_system<Component::WorldBounds const, Component::ColliderBox const>(System::collision_system, SYSTEM_MAIN_THREAD);
+    add_system<Component::Mortal const>(System::kill_system);
+    if (!is_headless())
+    {
+        add_system<Component::Transform, Component::PreviousTransform, Component::Interpolated const>(System::interpolation_system, SYSTEM_RENDER | SYSTEM_MAIN_THREAD);
+        add_system<Component::WorldBounds const>(System::debug_system, SYSTEM_RENDER | SYSTEM_MAIN_THREAD);
+        add_system<Component::Transform const, Component::PreviousTransform const, Component::Sprite const>(System::draw_system, SYSTEM_RENDER | SYSTEM_MAIN_THREAD);
+    }
 
-    add_receiver<Events::Collision>(Receiver::collision_receiver);
+    if (local_player)
+        Prefab::Player(*this, Component::Transform{.position = Vec2(0.0f, 250.0f), .rotation = 0.0f, .scale = Vec2(3.0f, 3.0f)}, Component::RigidBody{.mass = 1.0f, .velocity = Vec2(0.0f, 0.0f), .acceleration = Vec2(0.0f, 0.0f)});
+}
 
-    Prefab::Player(*this, Component::Transform{.position = Vec2(0.0f, 250.0f), .rotation = 0.0f, .scale = Vec2(3.0f, 3.0f)}, Component::RigidBody{.mass = 1.0f, .velocity = Vec2(0.0f, 0.0f), .acceleration = Vec2(0.0f, 0.0f), .delta_clock_movement = sf::Clock(), .delta_clock_physics = sf::Clock()});
+inline std::size_t Registry::update(float seconds)
+{
+    std::size_t ticks = 0;
 
-    while (_system_manager->_window.isOpen())
+    _timestep.accumulate(seconds);
+    _interpolation_clock.advance(seconds);
+    while (_timestep.consume_tick())
     {
-        _system_manager->_window.clear(sf::Color(238, 245, 178));
         run_systems();
+        ++ticks;
+    }
+    return ticks;
+}
+
+inline void Registry::run()
+{
+    setup();
+
+    auto last_frame = std::chrono::steady_clock::now();
+
+    _running = true;
+    while (_running && (is_headless() || _system_manager->_window.isOpen()))
+    {
+        auto now = std::chrono::steady_clock::now();
+
+        update(std::chrono::duration<float>(now - last_frame).count());
+        last_frame = now;
+        if (is_headless())
+        {
+            // nothing to render, sleep until the next tick is due
+            std::this_thread::sleep_for(std::chrono::duration<float>((1.0f - _timestep.get_alpha()) * _timestep.get_delta_time()));
+            continue;
+        }
+        _system_manager->_window.clear(sf::Color(238, 245, 178));
+        run_render_systems();
         _system_manager->_window.display();
     }
 }
 
-inline Registry::Registry()
+inline void Registry::stop()
+{
+    _running = false;
+}
+
+inline bool Registry::is_headless() const
+{
+    return !_system_manager;
+}
+
+inline Registry::Registry(bool headless)
     : _entity_manager(std::make_unique<EntityManager>()),
       _component_manager(std::make_unique<ComponentManager>()),
-      _system_manager(std::make_unique<SystemManager>()),
+      _system_manager(headless ? nullptr : std::make_unique<SystemManager>()),
       _event_manager(std::make_unique<EventManager>()),
+      _system_scheduler(std::make_unique<SystemScheduler>()),
+      _render_scheduler(std::make_unique<SystemScheduler>()),
+      _timestep(),
+      _interpolation_clock(),
+      _running(false),
       _camera(*this)
 {
 }
@@ -385,9 +647,19 @@ inline Entity Registry::entity_from_index(std::size_t idx)
     return _entity_manager->entity_from_index(idx);
 }
 
+inline Entity Registry::entity_from_handle(Entity::handle_type handle)
+{
+    return _entity_manager->entity_from_handle(handle);
+}
+
+inline bool Registry::is_alive(Entity const &e) const
+{
+    return _entity_manager->is_alive(e);
+}
+
 inline void Registry::kill_entity(Entity const &e)
 {
-    _entity_manager->kill_entity(*_component_manager, e);
+    _entity_manager->kill_entity(e);
 }
 
 template <class Component>
@@ -427,27 +699,68 @@ inline SparseArray<Component> const &Registry::get_components() const
 }
 
 template <class... Components, typename Function>
-inline void Registry::add_system(Function &&f)
+inline void Registry::add_system(Function &&f, int flags, Signature const &excluded)
 {
-    _systems.push_back([this, f = std::forward<Function>(f)](Registry &r)
-                       { f(r, get_components<Components>()...); });
+    Signature reads;
+    Signature writes;
+
+    ((std::is_const_v<Components> ? reads : writes).set(ComponentFamily<std::remove_const_t<Components>>::family()), ...);
+    ((flags & SYSTEM_RENDER) ? _render_scheduler : _system_scheduler)->add_system(make_system<Components...>(std::forward<Function>(f), excluded), reads, writes, flags);
 }
 
 template <class... Components, typename Function>
-inline void Registry::add_system(Function const &f)
+inline void Registry::add_system(Function const &f, int flags, Signature const &excluded)
 {
-    _systems.push_back([this, f](Registry &r)
-                       { f(r, get_components<Components>()...); });
+    Signature reads;
+    Signature writes;
+
+    ((std::is_const_v<Components> ? reads : writes).set(ComponentFamily<std::remove_const_t<Components>>::family()), ...);
+    ((flags & SYSTEM_RENDER) ? _render_scheduler : _system_scheduler)->add_system(make_system<Components...>(f, excluded), reads, writes, flags);
 }
 
-inline void Registry::run_systems()
+template <class... Components, typename Function>
+inline std::function<void(Registry &)> Registry::make_system(Function &&f, Signature const &excluded)
 {
-    for (const auto &system : _systems)
+    std::tuple<SparseArray<std::remove_const_t<Components>> &...> components(get_components<std::remove_const_t<Components>>()...);
+
+    if constexpr (std::is_invocable_v<Function &, Registry &, View const &, SparseArray<std::remove_const_t<Components>> &...>)
     {
-        system(*this);
+        Signature mask;
+
+        (mask.set(ComponentFamily<std::remove_const_t<Components>>::family()), ...);
+        View const *view = &_entity_manager->get_view(mask, excluded);
+
+        return [f = std::forward<Function>(f), view, components](Registry &r)
+        { std::apply([&](auto &...cs)
+                     { f(r, *view, cs...); },
+                     components); };
+    }
+    else
+    {
+        return [f = std::forward<Function>(f), components](Registry &r)
+        { std::apply([&](auto &...cs)
+                     { f(r, cs...); },
+                     components); };
     }
 }
 
+inline void Registry::run_systems()
+{
+    _system_scheduler->run(*this);
+    _entity_manager->flush_killed_entities(*_component_manager);
+}
+
+inline void Registry::run_render_systems()
+{
+    _render_scheduler->run(*this);
+    _entity_manager->flush_killed_entities(*_component_manager);
+}
+
+inline void Registry::set_worker_count(std::size_t count)
+{
+    _system_scheduler->set_worker_count(count);
+}
+
 template <typename Event, typename Function>
 inline ConnectionID Registry::add_receiver(Function &&f)
 {
@@ -472,7 +785,34 @@ inline ComponentManager &Registry::get_component_manager()
 
 inline SystemManager &Registry::get_system_manager()
 {
+    if (!_system_manager)
+        throw std::runtime_error("The registry is headless");
     return *_system_manager;
 }
 
+inline ThreadPool &Registry::get_thread_pool()
+{
+    return _system_scheduler->get_thread_pool();
+}
+
+inline Timestep &Registry::get_timestep()
+{
+    return _timestep;
+}
+
+inline Timestep const &Registry::get_timestep() const
+{
+    return _timestep;
+}
+
+inline InterpolationClock &Registry::get_interpolation_clock()
+{
+    return _interpolation_clock;
+}
+
+inline InterpolationClock const &Registry::get_interpolation_clock() const
+{
+    return _interpolation_clock;
+}
+
 #endif /* REGISTRY_HPP */
@@ -7,6 +7,8 @@
 #include <utility>
 #include <vector>
 
+#include "StoragePolicy.hpp"
+
 /**
  * @brief The array that regroups all the components
  * of a specific type. In the sparse array the index
@@ -18,13 +20,24 @@
  * std::optional.
  * 
  * 
+ * The storage of the components is selected with the
+ * StoragePolicy of the component type, the layout
+ * described above is the default SparseStorage one.
+ *
  * @tparam Component The type of component contained
  * in the sparse array.
+ * @tparam Storage The storage tag of the sparse array
+ * (SparseStorage or DenseStorage).
  */
+template <typename Component, typename Storage = typename StoragePolicy<Component>::type>
+class SparseArray;
+
 template <typename Component>
-class SparseArray
+class SparseArray<Component, SparseStorage>
 {
 public:
+    using storage_type = SparseStorage;
+    using component_type = Component;
     using value_type = std::optional<Component>;
     using reference_type = value_type &;
     using const_reference_type = value_type const &;
@@ -56,6 +69,7 @@ public:
     const_iterator cend() const;
 
     size_type size() const;
+    size_type count() const;
 
     reference_type insert_at(size_type, Component const &);
     reference_type insert_at(size_type, Component &&);
@@ -64,10 +78,15 @@ public:
     reference_type emplace_at(size_type, Params &&...);
 
     void erase(size_type);
+    void clear();
 
     size_type get_index(value_type const &) const;
 
     bool doesContain(size_t) const;
+
+    Component &component_at(size_t);
+    Component const &component_at(size_t) const;
+
 private:
     /**
      * @brief the vector of optional components.
@@ -77,98 +96,110 @@ private:
 };
 
 template <typename Component>
-inline SparseArray<Component>::SparseArray()
+inline SparseArray<Component, SparseStorage>::SparseArray()
     : _data()
 {
 }
 
 template <typename Component>
-inline SparseArray<Component>::SparseArray(SparseArray const &other)
+inline SparseArray<Component, SparseStorage>::SparseArray(SparseArray const &other)
 {
     _data = other._data;
 }
 
 template <typename Component>
-inline SparseArray<Component>::SparseArray(SparseArray &&other) noexcept
+inline SparseArray<Component, SparseStorage>::SparseArray(SparseArray &&other) noexcept
 {
     _data = std::move(other._data);
 }
 
 template <typename Component>
-inline SparseArray<Component>::~SparseArray()
+inline SparseArray<Component, SparseStorage>::~SparseArray()
 {
 }
 
 template <typename Component>
-inline SparseArray<Component> &SparseArray<Component>::operator=(SparseArray const &other)
+inline SparseArray<Component, SparseStorage> &SparseArray<Component, SparseStorage>::operator=(SparseArray const &other)
 {
     _data = other._data;
     return *this;
 };
 
 template <typename Component>
-inline SparseArray<Component> &SparseArray<Component>::operator=(SparseArray &&other) noexcept
+inline SparseArray<Component, SparseStorage> &SparseArray<Component, SparseStorage>::operator=(SparseArray &&other) noexcept
 {
     _data = std::move(other._data);
     return *this;
 };
 
 template <typename Component>
-inline typename SparseArray<Component>::reference_type SparseArray<Component>::operator[](size_t idx)
+inline typename SparseArray<Component, SparseStorage>::reference_type SparseArray<Component, SparseStorage>::operator[](size_t idx)
 {
     return _data[idx];
 };
 
 template <typename Component>
-inline typename SparseArray<Component>::const_reference_type SparseArray<Component>::operator[](size_t idx) const
+inline typename SparseArray<Component, SparseStorage>::const_reference_type SparseArray<Component, SparseStorage>::operator[](size_t idx) const
 {
     return _data.at(idx);
 };
 
 template <typename Component>
-inline typename SparseArray<Component>::iterator SparseArray<Component>::begin()
+inline typename SparseArray<Component, SparseStorage>::iterator SparseArray<Component, SparseStorage>::begin()
 {
     return _data.begin();
 }
 
 template <typename Component>
-inline typename SparseArray<Component>::const_iterator SparseArray<Component>::begin() const
+inline typename SparseArray<Component, SparseStorage>::const_iterator SparseArray<Component, SparseStorage>::begin() const
 {
     return _data.begin();
 }
 
 template <typename Component>
-inline typename SparseArray<Component>::const_iterator SparseArray<Component>::cbegin() const
+inline typename SparseArray<Component, SparseStorage>::const_iterator SparseArray<Component, SparseStorage>::cbegin() const
 {
     return _data.cbegin();
 }
 
 template <typename Component>
-inline typename SparseArray<Component>::iterator SparseArray<Component>::end()
+inline typename SparseArray<Component, SparseStorage>::iterator SparseArray<Component, SparseStorage>::end()
 {
     return _data.end();
 }
 
 template <typename Component>
-inline typename SparseArray<Component>::const_iterator SparseArray<Component>::end() const
+inline typename SparseArray<Component, SparseStorage>::const_iterator SparseArray<Component, SparseStorage>::end() const
 {
     return _data.end();
 }
 
 template <typename Component>
-inline typename SparseArray<Component>::const_iterator SparseArray<Component>::cend() const
+inline typename SparseArray<Component, SparseStorage>::const_iterator SparseArray<Component, SparseStorage>::cend() const
 {
     return _data.cend();
 }
 
 template <typename Component>
-inline typename SparseArray<Component>::size_type SparseArray<Component>::size() const
+inline typename SparseArray<Component, SparseStorage>::size_type SparseArray<Component, SparseStorage>::size() const
 {
     return _data.size();
 }
 
+/**
+ * @brief Count the components attached in the sparse array.
+ * Warning: it walks every slot of the sparse array.
+ *
+ */
+template <typename Component>
+inline typename SparseArray<Component, SparseStorage>::size_type SparseArray<Component, SparseStorage>::count() const
+{
+    return std::count_if(_data.begin(), _data.end(), [](auto const &elem)
+                         { return elem.has_value(); });
+}
+
 template <typename Component>
-inline typename SparseArray<Component>::reference_type SparseArray<Component>::insert_at(size_type pos, Component const &component)
+inline typename SparseArray<Component, SparseStorage>::reference_type SparseArray<Component, SparseStorage>::insert_at(size_type pos, Component const &component)
 {
     if (pos >= _data.size())
         _data.resize(pos + 1);
@@ -177,7 +208,7 @@ inline typename SparseArray<Component>::reference_type SparseArray<Component>::i
 }
 
 template <typename Component>
-inline typename SparseArray<Component>::reference_type SparseArray<Component>::insert_at(size_type pos, Component &&component)
+inline typename SparseArray<Component, SparseStorage>::reference_type SparseArray<Component, SparseStorage>::insert_at(size_type pos, Component &&component)
 {
     if (pos >= _data.size())
         _data.resize(pos + 1);
@@ -187,7 +218,7 @@ inline typename SparseArray<Component>::reference_type SparseArray<Component>::i
 
 template <typename Component>
 template <class... Params>
-inline typename SparseArray<Component>::reference_type SparseArray<Component>::emplace_at(size_type pos, Params &&...params)
+inline typename SparseArray<Component, SparseStorage>::reference_type SparseArray<Component, SparseStorage>::emplace_at(size_type pos, Params &&...params)
 {
     if (pos >= _data.size())
         _data.resize(pos + 1);
@@ -198,21 +229,27 @@ inline typename SparseArray<Component>::reference_type SparseArray<Component>::e
 }
 
 template <typename Component>
-inline void SparseArray<Component>::erase(size_type pos)
+inline void SparseArray<Component, SparseStorage>::erase(size_type pos)
 {
     if (pos < _data.size())
         _data[pos].reset();
 }
 
 template <typename Component>
-inline typename SparseArray<Component>::size_type SparseArray<Component>::get_index(value_type const &value) const
+inline void SparseArray<Component, SparseStorage>::clear()
+{
+    _data.clear();
+}
+
+template <typename Component>
+inline typename SparseArray<Component, SparseStorage>::size_type SparseArray<Component, SparseStorage>::get_index(value_type const &value) const
 {
     return std::distance(_data.begin(), std::find_if(_data.begin(), _data.end(), [&value](auto &elem)
                                                      { return std::addressof(elem) == std::addressof(value); }));
 }
 
 template <typename Component>
-inline bool SparseArray<Component>::doesContain(size_t idx) const
+inline bool SparseArray<Component, SparseStorage>::doesContain(size_t idx) const
 {
     if (idx >= _data.size()) {
         return false;
@@ -221,4 +258,312 @@ inline bool SparseArray<Component>::doesContain(size_t idx) const
     }
 }
 
+template <typename Component>
+inline Component &SparseArray<Component, SparseStorage>::component_at(size_t idx)
+{
+    return *_data[idx];
+}
+
+template <typename Component>
+inline Component const &SparseArray<Component, SparseStorage>::component_at(size_t idx) const
+{
+    return *_data[idx];
+}
+
+/**
+ * @brief The packed layout of the sparse array (also
+ * called sparse set). Components are stored contiguously
+ * in a dense array, a second array keeps the entity id
+ * of each dense slot and a sparse index maps every
+ * entity id to its dense slot.
+ * Erasing a component moves the last component of the
+ * dense array into the freed slot, so references to
+ * components are only valid until the next erase.
+ *
+ * It is selected by specializing the StoragePolicy of
+ * the component type with DenseStorage.
+ *
+ * @tparam Component The type of component contained
+ * in the sparse array.
+ */
+template <typename Component>
+class SparseArray<Component, DenseStorage>
+{
+public:
+    using storage_type = DenseStorage;
+    using component_type = Component;
+    using value_type = Component;
+    using reference_type = value_type &;
+    using const_reference_type = value_type const &;
+    using container_t = std::vector<value_type>;
+    using size_type = typename container_t::size_type;
+
+    using iterator = typename container_t::iterator;
+    using const_iterator = typename container_t::const_iterator;
+
+    /**
+     * @brief The value of the sparse index for an entity
+     * that has no component attached.
+     *
+     */
+    static constexpr size_type NPOS = static_cast<size_type>(-1);
+
+public:
+    SparseArray();
+
+    SparseArray(SparseArray const &) = default;
+    SparseArray(SparseArray &&) noexcept = default;
+    ~SparseArray() = default;
+
+    SparseArray &operator=(SparseArray const &) = default;
+    SparseArray &operator=(SparseArray &&) noexcept = default;
+
+    reference_type operator[](size_t);
+    const_reference_type operator[](size_t) const;
+
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const;
+
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const;
+
+    size_type size() const;
+    size_type count() const;
+
+    reference_type insert_at(size_type, Component const &);
+    reference_type insert_at(size_type, Component &&);
+
+    template <class... Params>
+    reference_type emplace_at(size_type, Params &&...);
+
+    void erase(size_type);
+    void clear();
+
+    size_type get_index(value_type const &) const;
+
+    bool doesContain(size_t) const;
+
+    Component &component_at(size_t);
+    Component const &component_at(size_t) const;
+
+    std::vector<size_type> const &entities() const;
+
+private:
+    /**
+     * @brief Reserve a dense slot for an entity and
+     * return its position in the dense array.
+     *
+     */
+    size_type allocate_slot(size_type);
+
+    /**
+     * @brief The contiguous array of attached components.
+     *
+     */
+    container_t _dense;
+    /**
+     * @brief The entity id of each component of the
+     * dense array, at the same position.
+     *
+     */
+    std::vector<size_type> _entities;
+    /**
+     * @brief The position in the dense array of the
+     * component of each entity id, NPOS if the entity
+     * has none.
+     *
+     */
+    std::vector<size_type> _sparse;
+};
+
+template <typename Component>
+inline SparseArray<Component, DenseStorage>::SparseArray()
+    : _dense(),
+      _entities(),
+      _sparse()
+{
+}
+
+template <typename Component>
+inline typename SparseArray<Component, DenseStorage>::reference_type SparseArray<Component, DenseStorage>::operator[](size_t idx)
+{
+    return _dense[_sparse[idx]];
+}
+
+template <typename Component>
+inline typename SparseArray<Component, DenseStorage>::const_reference_type SparseArray<Component, DenseStorage>::operator[](size_t idx) const
+{
+    return _dense.at(_sparse.at(idx));
+}
+
+template <typename Component>
+inline typename SparseArray<Component, DenseStorage>::iterator SparseArray<Component, DenseStorage>::begin()
+{
+    return _dense.begin();
+}
+
+template <typename Component>
+inline typename SparseArray<Component, DenseStorage>::const_iterator SparseArray<Component, DenseStorage>::begin() const
+{
+    return _dense.begin();
+}
+
+template <typename Component>
+inline typename SparseArray<Component, DenseStorage>::const_iterator SparseArray<Component, DenseStorage>::cbegin() const
+{
+    return _dense.cbegin();
+}
+
+template <typename Component>
+inline typename SparseArray<Component, DenseStorage>::iterator SparseArray<Component, DenseStorage>::end()
+{
+    return _dense.end();
+}
+
+template <typename Component>
+inline typename SparseArray<Component, DenseStorage>::const_iterator SparseArray<Component, DenseStorage>::end() const
+{
+    return _dense.end();
+}
+
+template <typename Component>
+inline typename SparseArray<Component, DenseStorage>::const_iterator SparseArray<Component, DenseStorage>::cend() const
+{
+    return _dense.cend();
+}
+
+/**
+ * @brief Return the size of the entity index space of
+ * the sparse array, like the SparseStorage layout does.
+ * Use count() to get the number of attached components.
+ *
+ */
+template <typename Component>
+inline typename SparseArray<Component, DenseStorage>::size_type SparseArray<Component, DenseStorage>::size() const
+{
+    return _sparse.size();
+}
+
+template <typename Component>
+inline typename SparseArray<Component, DenseStorage>::size_type SparseArray<Component, DenseStorage>::count() const
+{
+    return _dense.size();
+}
+
+template <typename Component>
+inline typename SparseArray<Component, DenseStorage>::size_type SparseArray<Component, DenseStorage>::allocate_slot(size_type pos)
+{
+    if (pos >= _sparse.size())
+        _sparse.resize(pos + 1, NPOS);
+    _sparse[pos] = _dense.size();
+    _entities.push_back(pos);
+    return _sparse[pos];
+}
+
+template <typename Component>
+inline typename SparseArray<Component, DenseStorage>::reference_type SparseArray<Component, DenseStorage>::insert_at(size_type pos, Component const &component)
+{
+    if (doesContain(pos)) {
+        _dense[_sparse[pos]] = component;
+        return _dense[_sparse[pos]];
+    }
+    allocate_slot(pos);
+    _dense.push_back(component);
+    return _dense.back();
+}
+
+template <typename Component>
+inline typename SparseArray<Component, DenseStorage>::reference_type SparseArray<Component, DenseStorage>::insert_at(size_type pos, Component &&component)
+{
+    if (doesContain(pos)) {
+        _dense[_sparse[pos]] = std::move(component);
+        return _dense[_sparse[pos]];
+    }
+    allocate_slot(pos);
+    _dense.push_back(std::move(component));
+    return _dense.back();
+}
+
+template <typename Component>
+template <class... Params>
+inline typename SparseArray<Component, DenseStorage>::reference_type SparseArray<Component, DenseStorage>::emplace_at(size_type pos, Params &&...params)
+{
+    if (doesContain(pos)) {
+        _dense[_sparse[pos]] = Component(std::forward<Params>(params)...);
+        return _dense[_sparse[pos]];
+    }
+    allocate_slot(pos);
+    _dense.push_back(Component(std::forward<Params>(params)...));
+    return _dense.back();
+}
+
+template <typename Component>
+inline void SparseArray<Component, DenseStorage>::erase(size_type pos)
+{
+    if (!doesContain(pos))
+        return;
+    size_type slot = _sparse[pos];
+    size_type last = _dense.size() - 1;
+
+    if (slot != last) {
+        _dense[slot] = std::move(_dense[last]);
+        _entities[slot] = _entities[last];
+        _sparse[_entities[slot]] = slot;
+    }
+    _dense.pop_back();
+    _entities.pop_back();
+    _sparse[pos] = NPOS;
+}
+
+template <typename Component>
+inline void SparseArray<Component, DenseStorage>::clear()
+{
+    _dense.clear();
+    _entities.clear();
+    _sparse.clear();
+}
+
+template <typename Component>
+inline typename SparseArray<Component, DenseStorage>::size_type SparseArray<Component, DenseStorage>::get_index(value_type const &value) const
+{
+    size_type slot = std::addressof(value) - _dense.data();
+
+    return (slot < _entities.size() ? _entities[slot] : _sparse.size());
+}
+
+template <typename Component>
+inline bool SparseArray<Component, DenseStorage>::doesContain(size_t idx) const
+{
+    if (idx >= _sparse.size()) {
+        return false;
+    } else {
+        return _sparse[idx] != NPOS;
+    }
+}
+
+template <typename Component>
+inline Component &SparseArray<Component, DenseStorage>::component_at(size_t idx)
+{
+    return _dense[_sparse[idx]];
+}
+
+template <typename Component>
+inline Component const &SparseArray<Component, DenseStorage>::component_at(size_t idx) const
+{
+    return _dense[_sparse[idx]];
+}
+
+/**
+ * @brief Return the entity id of every attached
+ * component, in the order of the dense array.
+ *
+ */
+template <typename Component>
+inline std::vector<typename SparseArray<Component, DenseStorage>::size_type> const &SparseArray<Component, DenseStorage>::entities() const
+{
+    return _entities;
+}
+
 #endif /* SPARSE_ARRAY_HPP */
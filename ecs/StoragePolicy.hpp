@@ -0,0 +1,50 @@
+#ifndef STORAGE_POLICY_HPP
+#define STORAGE_POLICY_HPP
+
+/**
+ * @brief The storage tag of a SparseArray that keeps
+ * one std::optional per entity id. Lookups are a
+ * single index but iterating the array walks every
+ * slot up to the highest entity id ever attached.
+ *
+ */
+struct SparseStorage
+{
+};
+
+/**
+ * @brief The storage tag of a SparseArray that keeps
+ * its components packed in a contiguous array (also
+ * called sparse set). An entity-to-slot index makes
+ * lookups O(1) while iteration only visits the
+ * components that are actually attached.
+ *
+ */
+struct DenseStorage
+{
+};
+
+/**
+ * @brief Select the storage of the SparseArray of a
+ * component type. Every component is stored in a
+ * SparseStorage unless the policy is specialized
+ * next to the component declaration.
+ *
+ * e.g:
+ * ```cpp
+ * template <>
+ * struct StoragePolicy<Component::Input>
+ * {
+ *     using type = DenseStorage;
+ * };
+ * ```
+ *
+ * @tparam Component The type of component stored.
+ */
+template <typename Component>
+struct StoragePolicy
+{
+    using type = SparseStorage;
+};
+
+#endif /* STORAGE_POLICY_HPP */
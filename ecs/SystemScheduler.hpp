@@ -0,0 +1,259 @@
+#ifndef SYSTEM_SCHEDULER_HPP
+#define SYSTEM_SCHEDULER_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "ComponentFamily.hpp"
+#include "ThreadPool.hpp"
+
+class Registry;
+
+/**
+ * @brief The flags of a system, given to Registry::add_system().
+ *
+ */
+enum systemFlag {
+    /**
+     * @brief The system only uses the components it declares
+     * and may run on any thread.
+     *
+     */
+    SYSTEM_DEFAULT = 0,
+    /**
+     * @brief The system must run on the thread calling
+     * Registry::run_systems(), e.g. because it uses the window.
+     * Two such systems never run at the same time.
+     *
+     */
+    SYSTEM_MAIN_THREAD = 1 << 0,
+    /**
+     * @brief The system uses more than its declared components
+     * (other pools, entities creation, events, ...) so it never
+     * runs at the same time as another system.
+     *
+     */
+    SYSTEM_EXCLUSIVE = 1 << 1,
+    /**
+     * @brief The system renders the game (or reads the window
+     * inputs), so it runs once per rendered frame with
+     * Registry::run_render_systems() instead of once per
+     * simulation tick.
+     *
+     */
+    SYSTEM_RENDER = 1 << 2,
+};
+
+/**
+ * @brief Runs the systems of the game engine. Each system
+ * declares the component families it reads and writes, and
+ * two systems conflict when one of them writes a component
+ * family used by the other. Systems are grouped in waves
+ * where no two systems conflict, and a system is put in the
+ * wave after the last system added before it that it
+ * conflicts with. So every conflicting pair of systems runs
+ * in the order they were added, and the results match a
+ * serial run.
+ * Without worker threads (the default) the systems simply
+ * run one after the other.
+ *
+ */
+class SystemScheduler
+{
+public:
+    using system_type = std::function<void(Registry &)>;
+
+    SystemScheduler();
+    ~SystemScheduler();
+
+    /**
+     * @brief Add a system after every system already added.
+     *
+     * @param system The system.
+     * @param reads The component families only read by the system.
+     * @param writes The component families written by the system.
+     * @param flags The systemFlag of the system.
+     */
+    void add_system(system_type system, Signature const &reads, Signature const &writes, int flags);
+
+    /**
+     * @brief Set the number of worker threads running the
+     * systems along with the calling thread. 0 runs the
+     * systems serially.
+     *
+     * @param count The number of worker threads.
+     */
+    void set_worker_count(std::size_t count);
+    /**
+     * @brief Get the number of worker threads.
+     *
+     */
+    std::size_t get_worker_count() const;
+    /**
+     * @brief Get the pool of worker threads.
+     *
+     */
+    ThreadPool &get_thread_pool();
+
+    /**
+     * @brief Get the waves of systems indexes, in running order.
+     *
+     */
+    std::vector<std::vector<std::size_t>> const &get_waves();
+
+    /**
+     * @brief Run every system once.
+     *
+     * @param r The registry given to the systems.
+     */
+    void run(Registry &r);
+
+private:
+    /**
+     * @brief A system and its declared accesses.
+     *
+     */
+    struct SystemEntry
+    {
+        system_type system;
+        Signature reads;
+        Signature writes;
+        int flags;
+    };
+
+    static bool conflicts(SystemEntry const &lhs, SystemEntry const &rhs);
+    void build_waves();
+
+    /**
+     * @brief The systems, in the order they were added.
+     *
+     */
+    std::vector<SystemEntry> _systems;
+    /**
+     * @brief The systems indexes grouped in waves.
+     *
+     */
+    std::vector<std::vector<std::size_t>> _waves;
+    /**
+     * @brief Indicate if the waves must be built again.
+     *
+     */
+    bool _dirty;
+    /**
+     * @brief The worker threads.
+     *
+     */
+    std::unique_ptr<ThreadPool> _pool;
+};
+
+inline SystemScheduler::SystemScheduler()
+    : _systems(),
+      _waves(),
+      _dirty(false),
+      _pool(std::make_unique<ThreadPool>(0))
+{
+}
+
+inline SystemScheduler::~SystemScheduler()
+{
+}
+
+inline void SystemScheduler::add_system(system_type system, Signature const &reads, Signature const &writes, int flags)
+{
+    _systems.push_back(SystemEntry{std::move(system), reads & ~writes, writes, flags});
+    _dirty = true;
+}
+
+inline void SystemScheduler::set_worker_count(std::size_t count)
+{
+    if (count != _pool->get_worker_count())
+        _pool = std::make_unique<ThreadPool>(count);
+}
+
+inline std::size_t SystemScheduler::get_worker_count() const
+{
+    return _pool->get_worker_count();
+}
+
+inline ThreadPool &SystemScheduler::get_thread_pool()
+{
+    return *_pool;
+}
+
+inline std::vector<std::vector<std::size_t>> const &SystemScheduler::get_waves()
+{
+    if (_dirty)
+        build_waves();
+    return _waves;
+}
+
+inline bool SystemScheduler::conflicts(SystemEntry const &lhs, SystemEntry const &rhs)
+{
+    if ((lhs.flags & SYSTEM_EXCLUSIVE) || (rhs.flags & SYSTEM_EXCLUSIVE))
+        return true;
+    if ((lhs.flags & SYSTEM_MAIN_THREAD) && (rhs.flags & SYSTEM_MAIN_THREAD))
+        return true;
+    return (lhs.writes & (rhs.reads | rhs.writes)).any() || (rhs.writes & lhs.reads).any();
+}
+
+inline void SystemScheduler::build_waves()
+{
+    std::vector<std::size_t> levels(_systems.size(), 0);
+
+    _waves.clear();
+    for (std::size_t i = 0; i < _systems.size(); i++)
+    {
+        for (std::size_t j = 0; j < i; j++)
+        {
+            if (levels[j] + 1 > levels[i] && conflicts(_systems[j], _systems[i]))
+                levels[i] = levels[j] + 1;
+        }
+        if (levels[i] >= _waves.size())
+            _waves.resize(levels[i] + 1);
+        _waves[levels[i]].push_back(i);
+    }
+    _dirty = false;
+}
+
+inline void SystemScheduler::run(Registry &r)
+{
+    if (_pool->get_worker_count() == 0)
+    {
+        for (auto const &entry : _systems)
+            entry.system(r);
+        return;
+    }
+    for (auto const &wave : get_waves())
+    {
+        for (std::size_t idx : wave)
+        {
+            if (!(_systems[idx].flags & SYSTEM_MAIN_THREAD))
+                _pool->submit([this, idx, &r]()
+                              { _systems[idx].system(r); });
+        }
+        try
+        {
+            for (std::size_t idx : wave)
+            {
+                if (_systems[idx].flags & SYSTEM_MAIN_THREAD)
+                    _systems[idx].system(r);
+            }
+        }
+        catch (...)
+        {
+            // the workers still use the registry, let them finish first
+            try
+            {
+                _pool->wait();
+            }
+            catch (...)
+            {
+            }
+            throw;
+        }
+        _pool->wait();
+    }
+}
+
+#endif /* SYSTEM_SCHEDULER_HPP */
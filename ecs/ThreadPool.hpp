@@ -0,0 +1,300 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A fixed set of worker threads running the tasks
+ * submitted to it. A pool without worker runs every task
+ * on the calling thread, during wait().
+ *
+ * e.g:
+ * ```cpp
+ * ThreadPool pool(4);
+ *
+ * pool.submit([]() { ... });
+ * pool.submit([]() { ... });
+ * pool.wait();
+ * ```
+ *
+ */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(std::size_t workers = 0);
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool &operator=(ThreadPool const &) = delete;
+
+    /**
+     * @brief Get the number of worker threads.
+     *
+     */
+    std::size_t get_worker_count() const;
+
+    /**
+     * @brief Queue a task to be run by a worker.
+     *
+     * @param task The task.
+     */
+    void submit(std::function<void()> task);
+    /**
+     * @brief Wait until every submitted task is done. If a
+     * task threw an exception, the first one is rethrown.
+     *
+     */
+    void wait();
+
+    /**
+     * @brief Split the range [begin, end) in chunks and call a
+     * function on each chunk, from the workers and the calling
+     * thread. The chunks are claimed one by one from a shared
+     * counter, so a thread that is done with its chunk takes the
+     * next one left and the work balances itself. The call
+     * returns once every chunk is done, the calling thread
+     * working on them as well, so it can be used from a task of
+     * the pool itself. If the function threw an exception, the
+     * first one is rethrown.
+     *
+     * @param begin The first index of the range.
+     * @param end The index past the last one of the range.
+     * @param grain The chunks boundaries are multiples of it.
+     * @param f The function, called with the first index and
+     * the index past the last one of each chunk.
+     */
+    void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, std::function<void(std::size_t, std::size_t)> const &f);
+
+private:
+    void work();
+    void run_task(std::function<void()> &task);
+
+    /**
+     * @brief The worker threads.
+     *
+     */
+    std::vector<std::thread> _workers;
+    /**
+     * @brief The tasks waiting for a worker.
+     *
+     */
+    std::queue<std::function<void()>> _tasks;
+    /**
+     * @brief The number of submitted tasks not done yet.
+     *
+     */
+    std::size_t _pending;
+    /**
+     * @brief The first exception thrown by a task since
+     * the last wait().
+     *
+     */
+    std::exception_ptr _error;
+    /**
+     * @brief Indicate if the workers must stop.
+     *
+     */
+    bool _stop;
+    std::mutex _mutex;
+    /**
+     * @brief Notified when a task is submitted.
+     *
+     */
+    std::condition_variable _task_ready;
+    /**
+     * @brief Notified when the last pending task is done.
+     *
+     */
+    std::condition_variable _tasks_done;
+};
+
+inline ThreadPool::ThreadPool(std::size_t workers)
+    : _workers(),
+      _tasks(),
+      _pending(0),
+      _error(),
+      _stop(false)
+{
+    for (std::size_t i = 0; i < workers; i++)
+        _workers.emplace_back(&ThreadPool::work, this);
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _stop = true;
+    }
+    _task_ready.notify_all();
+    for (auto &worker : _workers)
+        worker.join();
+}
+
+inline std::size_t ThreadPool::get_worker_count() const
+{
+    return _workers.size();
+}
+
+inline void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _tasks.push(std::move(task));
+        ++_pending;
+    }
+    _task_ready.notify_one();
+}
+
+inline void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (_workers.empty())
+    {
+        while (!_tasks.empty())
+        {
+            std::function<void()> task = std::move(_tasks.front());
+
+            _tasks.pop();
+            lock.unlock();
+            run_task(task);
+            lock.lock();
+        }
+    }
+    _tasks_done.wait(lock, [this]()
+                     { return _pending == 0; });
+    if (_error)
+        std::rethrow_exception(std::exchange(_error, nullptr));
+}
+
+inline void ThreadPool::parallel_for(std::size_t begin, std::size_t end, std::size_t grain, std::function<void(std::size_t, std::size_t)> const &f)
+{
+    // a worker may only start once every chunk is done and the call returned,
+    // so the state outlives the call and f is only reached through a claimed chunk
+    struct State
+    {
+        std::function<void(std::size_t, std::size_t)> const *f;
+        std::size_t begin;
+        std::size_t end;
+        std::size_t chunk;
+        std::size_t first;
+        std::size_t count;
+        std::atomic<std::size_t> next;
+        std::size_t done;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable all_done;
+    };
+
+    if (begin >= end)
+        return;
+    grain = std::max<std::size_t>(grain, 1);
+    // a few chunks per thread so a slow chunk doesn't hold back the others
+    std::size_t chunk = (end - begin + 4 * (_workers.size() + 1) - 1) / (4 * (_workers.size() + 1));
+
+    chunk = (chunk + grain - 1) / grain * grain;
+    if (_workers.empty() || end - begin <= chunk)
+    {
+        f(begin, end);
+        return;
+    }
+    auto state = std::make_shared<State>();
+
+    state->f = &f;
+    state->begin = begin;
+    state->end = end;
+    state->chunk = chunk;
+    state->first = begin / chunk;
+    state->count = (end + chunk - 1) / chunk - state->first;
+    state->next = 0;
+    state->done = 0;
+    auto run_chunks = [](State &st)
+    {
+        for (std::size_t i = st.next++; i < st.count; i = st.next++)
+        {
+            std::size_t chunk_begin = std::max(st.begin, (st.first + i) * st.chunk);
+            std::size_t chunk_end = std::min(st.end, (st.first + i + 1) * st.chunk);
+            std::exception_ptr error;
+
+            try
+            {
+                (*st.f)(chunk_begin, chunk_end);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(st.mutex);
+
+            if (error && !st.error)
+                st.error = error;
+            if (++st.done == st.count)
+                st.all_done.notify_all();
+        }
+    };
+
+    for (std::size_t i = 0; i < std::min(_workers.size(), state->count - 1); i++)
+        submit([state, run_chunks]()
+               { run_chunks(*state); });
+    run_chunks(*state);
+    std::unique_lock<std::mutex> lock(state->mutex);
+
+    state->all_done.wait(lock, [&state]()
+                         { return state->done == state->count; });
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
+
+inline void ThreadPool::work()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (true)
+    {
+        _task_ready.wait(lock, [this]()
+                         { return _stop || !_tasks.empty(); });
+        if (_stop && _tasks.empty())
+            return;
+        std::function<void()> task = std::move(_tasks.front());
+
+        _tasks.pop();
+        lock.unlock();
+        run_task(task);
+        lock.lock();
+    }
+}
+
+inline void ThreadPool::run_task(std::function<void()> &task)
+{
+    std::exception_ptr error;
+
+    try
+    {
+        task();
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (error && !_error)
+        _error = error;
+    if (--_pending == 0)
+        _tasks_done.notify_all();
+}
+
+#endif /* THREAD_POOL_HPP */
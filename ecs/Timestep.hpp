@@ -0,0 +1,147 @@
+#ifndef TIMESTEP_HPP
+#define TIMESTEP_HPP
+
+#include <cstdint>
+
+/**
+ * @brief The fixed-timestep clock of the simulation. The
+ * time elapsed between two rendered frames is accumulated,
+ * and the simulation advances by whole ticks of the same
+ * delta time, so it doesn't depend on the frame rate. The
+ * time left in the accumulator is exposed as the alpha,
+ * the fraction of a tick the rendered frame is ahead of
+ * the simulation.
+ *
+ * e.g:
+ * ```cpp
+ * Timestep &timestep = registry.get_timestep();
+ *
+ * timestep.accumulate(frame_seconds);
+ * while (timestep.consume_tick())
+ *     registry.run_systems();
+ * registry.run_render_systems();
+ * ```
+ *
+ */
+class Timestep
+{
+public:
+    /**
+     * @brief The default delta time of a tick, in seconds.
+     *
+     */
+    static constexpr float DEFAULT_DELTA_TIME = 1.0f / 60.0f;
+    /**
+     * @brief The longest frame time accumulated, in seconds.
+     * A longer frame (e.g. the window being dragged) drops
+     * the extra time instead of running a burst of ticks
+     * that would make the next frame even longer.
+     *
+     */
+    static constexpr float MAX_FRAME_TIME = 0.25f;
+
+    explicit Timestep(float delta_time = DEFAULT_DELTA_TIME);
+    ~Timestep();
+
+    /**
+     * @brief Get the delta time of a tick, in seconds.
+     *
+     */
+    float get_delta_time() const;
+    /**
+     * @brief Set the delta time of a tick, in seconds.
+     *
+     * @param delta_time The delta time, it must be positive.
+     */
+    void set_delta_time(float delta_time);
+    /**
+     * @brief Get the fraction of a tick accumulated and not
+     * simulated yet, in [0, 1).
+     *
+     */
+    float get_alpha() const;
+    /**
+     * @brief Get the number of ticks simulated so far.
+     *
+     */
+    std::uint64_t get_tick() const;
+
+    /**
+     * @brief Add the time elapsed since the last frame.
+     *
+     * @param seconds The elapsed time, in seconds.
+     */
+    void accumulate(float seconds);
+    /**
+     * @brief Take a tick from the accumulated time.
+     *
+     * @return true A tick must be simulated.
+     * @return false Less than a tick is accumulated.
+     */
+    bool consume_tick();
+
+private:
+    /**
+     * @brief The delta time of a tick, in seconds.
+     *
+     */
+    float _delta_time;
+    /**
+     * @brief The time accumulated and not simulated yet,
+     * in seconds.
+     *
+     */
+    float _accumulator;
+    /**
+     * @brief The number of ticks simulated so far.
+     *
+     */
+    std::uint64_t _tick;
+};
+
+inline Timestep::Timestep(float delta_time)
+    : _delta_time(delta_time),
+      _accumulator(0.0f),
+      _tick(0)
+{
+}
+
+inline Timestep::~Timestep()
+{
+}
+
+inline float Timestep::get_delta_time() const
+{
+    return _delta_time;
+}
+
+inline void Timestep::set_delta_time(float delta_time)
+{
+    _delta_time = delta_time;
+}
+
+inline float Timestep::get_alpha() const
+{
+    return _accumulator / _delta_time;
+}
+
+inline std::uint64_t Timestep::get_tick() const
+{
+    return _tick;
+}
+
+inline void Timestep::accumulate(float seconds)
+{
+    _accumulator += (seconds < MAX_FRAME_TIME ? seconds : MAX_FRAME_TIME);
+}
+
+inline bool Timestep::consume_tick()
+{
+    if (_accumulator < _delta_time)
+        return false;
+    _accumulator -= _delta_time;
+    ++_tick;
+    return true;
+}
+
+#endif /* TIMESTEP_HPP */
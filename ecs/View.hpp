@@ -0,0 +1,192 @@
+#ifndef VIEW_HPP
+#define VIEW_HPP
+
+#include <cstddef>
+#include <vector>
+#include "ComponentFamily.hpp"
+
+/**
+ * @brief The cached list of the entities that have a set
+ * of components attached, and none of an excluded set
+ * (e.g. a tag component). The EntityManager updates the
+ * views every time the signature of an entity changes, so
+ * a system iterating a view only visits the entities it
+ * matches, without checking each SparseArray.
+ * Entities are kept packed: removing an entity moves the
+ * last entity of the view into its place, so the order of
+ * the entities isn't preserved.
+ *
+ * e.g:
+ * ```cpp
+ * void movement_system(Registry &r, View const &view,
+ *                      SparseArray<Component::Transform> &transforms,
+ *                      SparseArray<Component::RigidBody> &rigid_bodies)
+ * {
+ *     for (auto &&[tf, rb] : containers::Zipper(view, transforms, rigid_bodies))
+ *     {
+ *         ...
+ *     }
+ * }
+ * ```
+ *
+ */
+class View
+{
+public:
+    static constexpr std::size_t NPOS = static_cast<std::size_t>(-1);
+
+    explicit View(Signature const &mask, Signature const &excluded = Signature());
+    /**
+     * @brief Construct a view of a single entity, e.g. to run
+     * a system on it only. It requires no component and isn't
+     * updated by the EntityManager, so the entity must have
+     * the components of the systems it is given to.
+     *
+     * @param e The entity index.
+     */
+    explicit View(std::size_t e);
+    ~View();
+
+    /**
+     * @brief Get the component families required by the view.
+     *
+     */
+    Signature const &get_mask() const;
+    /**
+     * @brief Get the component families the matching entities
+     * must not have attached.
+     *
+     */
+    Signature const &get_excluded() const;
+    /**
+     * @brief Get the indexes of the matching entities.
+     *
+     */
+    std::vector<std::size_t> const &entities() const;
+    /**
+     * @brief Get the number of matching entities.
+     *
+     */
+    std::size_t size() const;
+    /**
+     * @brief Indicate if an entity matches the view.
+     *
+     * @param e The entity index.
+     */
+    bool contains(std::size_t e) const;
+
+    /**
+     * @brief Add or remove an entity according to its new
+     * signature.
+     *
+     * @param e The entity index.
+     * @param signature The component families attached to
+     * the entity.
+     */
+    void update(std::size_t e, Signature const &signature);
+
+private:
+    void insert(std::size_t e);
+    void erase(std::size_t e);
+
+    /**
+     * @brief The component families an entity must have
+     * attached to match the view.
+     *
+     */
+    Signature _mask;
+    /**
+     * @brief The component families an entity must not have
+     * attached to match the view.
+     *
+     */
+    Signature _excluded;
+    /**
+     * @brief The packed indexes of the matching entities.
+     *
+     */
+    std::vector<std::size_t> _entities;
+    /**
+     * @brief The position of each entity index in _entities,
+     * NPOS if the entity doesn't match the view.
+     *
+     */
+    std::vector<std::size_t> _positions;
+};
+
+inline View::View(Signature const &mask, Signature const &excluded)
+    : _mask(mask),
+      _excluded(excluded),
+      _entities(),
+      _positions()
+{
+}
+
+inline View::View(std::size_t e)
+    : _mask(),
+      _excluded(),
+      _entities(),
+      _positions()
+{
+    insert(e);
+}
+
+inline View::~View()
+{
+}
+
+inline Signature const &View::get_mask() const
+{
+    return _mask;
+}
+
+inline Signature const &View::get_excluded() const
+{
+    return _excluded;
+}
+
+inline std::vector<std::size_t> const &View::entities() const
+{
+    return _entities;
+}
+
+inline std::size_t View::size() const
+{
+    return _entities.size();
+}
+
+inline bool View::contains(std::size_t e) const
+{
+    return (e < _positions.size()) && (_positions[e] != NPOS);
+}
+
+inline void View::update(std::size_t e, Signature const &signature)
+{
+    bool matches = ((signature & _mask) == _mask) && (signature & _excluded).none();
+
+    if (matches && !contains(e))
+        insert(e);
+    else if (!matches && contains(e))
+        erase(e);
+}
+
+inline void View::insert(std::size_t e)
+{
+    if (e >= _positions.size())
+        _positions.resize(e + 1, NPOS);
+    _positions[e] = _entities.size();
+    _entities.push_back(e);
+}
+
+inline void View::erase(std::size_t e)
+{
+    std::size_t pos = _positions[e];
+    std::size_t last = _entities.back();
+
+    _entities[pos] = last;
+    _positions[last] = pos;
+    _entities.pop_back();
+    _positions[e] = NPOS;
+}
+
+#endif /* VIEW_HPP */
@@ -8,6 +8,8 @@
 #include <iostream>
 
 #include "SparseArray.hpp"
+#include "ZipperMode.hpp"
+#include "View.hpp"
 
 namespace containers
 {
@@ -25,52 +27,51 @@ namespace containers
     template <class... Containers>
     class ZipperIterator
     {
-        template <class Container>
-        using iterator_t = typename Container::iterator;
-        template <class Container>
-        using it_reference_t = typename iterator_t<Container>::reference;
-
     public:
-        using value_type = std::tuple<typename Containers::value_type::value_type &...>; // std:: tuple of references to components
+        using value_type = std::tuple<typename Containers::component_type &...>; // std:: tuple of references to components
         using reference = value_type;
         using pointer = void;
         using difference_type = size_t;
         using iterator_category = std::forward_iterator_tag;
-        using iterator_tuple = std::tuple<iterator_t<Containers>...>;
+        using container_tuple = std::tuple<Containers *...>;
         friend containers::Zipper<Containers...>;
 
         /**
          * @brief Construct a new Zipper Iterator object. This constructor
          * was meant to be used by the Zipper class only.
          * 
-         * @param it_tuple A tuple of iterators on each of the
+         * @param containers A tuple of pointers on each of the
          * SparseArray that will regroups the ZipperIterator.
+         * @param ids The entity indexes to iterate over, or nullptr
+         * to iterate over the whole entity index space.
+         * @param probe Whether each entity must be checked
+         * to have every component attached.
          * @param max The expected maximum size of the ZipperIterator.
-         * @param idx The starting position of the index.
+         * @param pos The starting position of the iterator.
          */
-        ZipperIterator(iterator_tuple const &it_tuple, size_t max, size_t idx) : _current(it_tuple), _max(max), _idx(idx)
+        ZipperIterator(container_tuple const &containers, std::size_t const *ids, bool probe, size_t max, size_t pos) : _containers(containers), _ids(ids), _probe(probe), _max(max), _pos(pos)
         {
-            if (_idx != max && !all_set(_seq))
+            if (_pos != max && !all_set(_seq))
             {
                 incr_all(_seq);
             }
         }
 
     public:
-        ZipperIterator(ZipperIterator const &z) : _current(z._current), _max(z._max), _idx(z._idx) {}
+        ZipperIterator(ZipperIterator const &z) : _containers(z._containers), _ids(z._ids), _probe(z._probe), _max(z._max), _pos(z._pos) {}
 
-        ZipperIterator operator++()
+        ZipperIterator &operator++()
         {
-            ZipperIterator tmp = *this;
             incr_all(_seq);
-
-            return tmp;
+            return *this;
         }
 
-        ZipperIterator &operator++(int)
+        ZipperIterator operator++(int)
         {
+            ZipperIterator tmp = *this;
             incr_all(_seq);
-            return _current;
+
+            return tmp;
         }
 
         value_type operator*()
@@ -84,37 +85,37 @@ namespace containers
         }
 
         /**
-         * @brief Compare if two iterators are on the same index.
+         * @brief Compare if two iterators are on the same position.
          * 
          * @param lhs The left ZipperIterator.
          * @param rhs The right ZipperIterator.
-         * @return true The two iterators are on the same index.
-         * @return false The two iterators aren't on the same index.
+         * @return true The two iterators are on the same position.
+         * @return false The two iterators aren't on the same position.
          */
         friend bool operator==(ZipperIterator const &lhs, ZipperIterator const
                                                               &rhs)
         {
-            return (lhs._idx == rhs._idx);
+            return (lhs._pos == rhs._pos);
         }
         /**
-         * @brief Compare if two iterators aren't on the same index.
+         * @brief Compare if two iterators aren't on the same position.
          * 
          * @param lhs The left ZipperIterator.
          * @param rhs The right ZipperIterator.
-         * @return true The two iterators aren't on the same index.
-         * @return false The two iterators are on the same index.
+         * @return true The two iterators aren't on the same position.
+         * @return false The two iterators are on the same position.
          */
         friend bool operator!=(ZipperIterator const &lhs, ZipperIterator const
                                                               &rhs)
         {
-            return (lhs._idx != rhs._idx);
+            return (lhs._pos != rhs._pos);
         }
 
     private:
         /**
-         * @brief Increment every iterator at the same time.
-         * It also skips to the next value if one of the pointed
-         * to std::optional does not contains a value.
+         * @brief Increment the position of the iterator.
+         * It also skips to the next position if one of the
+         * SparseArray does not contains a component for its entity.
          * 
          * @tparam Is The index sequence that represents the number
          * of SparseArray that are zipped in the ZipperIterator.
@@ -126,14 +127,13 @@ namespace containers
         {
             do
             {
-                (std::get<Is>(_current)++, ...);
-                ++_idx;
-            } while ((_idx != _max) && !all_set(_seq));
+                ++_pos;
+            } while ((_pos != _max) && !all_set(_seq));
         }
 
         /**
-         * @brief Check if every SparseArray iterators point
-         * to a set std::optional. Meaning that the entity for this
+         * @brief Check if every SparseArray contains a component
+         * at the current index. Meaning that the entity for this
          * index have all of the components of the ZipperIterator type
          * attached to itself.
          * 
@@ -141,13 +141,26 @@ namespace containers
          * of SparseArray that are zipped in the ZipperIterator.
          * The value corresponding value can be found in the static
          * member "_seq".
-         * @return true Every std::optional are set.
-         * @return false One or more std::optional isn't set.
+         * @return true Every component is attached.
+         * @return false One or more component isn't attached.
          */
         template <size_t... Is>
         bool all_set(std::index_sequence<Is...>)
         {
-            return ((*std::get<Is>(_current)) && ... && true);
+            if (!_probe)
+                return true;
+            std::size_t idx = entity();
+
+            return (std::get<Is>(_containers)->doesContain(idx) && ... && true);
+        }
+
+        /**
+         * @brief Return the entity index of the current position.
+         *
+         */
+        std::size_t entity() const
+        {
+            return (_ids ? _ids[_pos] : _pos);
         }
 
         /**
@@ -162,28 +175,41 @@ namespace containers
         template <size_t... Is>
         value_type to_value(std::index_sequence<Is...>)
         {
-            return std::tie((**(std::get<Is>(_current)))...);
+            std::size_t idx = entity();
+
+            return std::tie(std::get<Is>(_containers)->component_at(idx)...);
         }
 
     private:
         /**
-         * @brief A tuple of iterators to each SparseArray
+         * @brief A tuple of pointers to each SparseArray
          * that regroups the ZipperIterator.
          * 
          */
-        iterator_tuple _current;
+        container_tuple _containers;
+        /**
+         * @brief The entity indexes the iterator walks through,
+         * nullptr when it walks the whole entity index space.
+         *
+         */
+        std::size_t const *_ids;
+        /**
+         * @brief Indicate if the iterator checks that each
+         * entity has every component attached.
+         *
+         */
+        bool _probe;
         /**
          * @brief A maximum that is used to prevent infinite loop.
-         * It is computed from the minimum of each SparseArrays size.
+         * It is the number of entity indexes to walk through.
          * 
          */
         size_t _max;
         /**
-         * @brief The index of the current position of each iterators
-         * int theirs SparseArrays.
+         * @brief The current position of the iterator.
          * 
          */
-        size_t _idx;
+        size_t _pos;
 
         static constexpr std::index_sequence_for<Containers...> _seq{};
     };
@@ -0,0 +1,18 @@
+#ifndef ZIPPER_MODE_HPP
+#define ZIPPER_MODE_HPP
+
+#include <cstddef>
+
+namespace containers
+{
+    /**
+     * @brief The chunks of a parallel_each() iteration start
+     * at multiples of this number of positions, so threads
+     * working on adjacent chunks of a SparseArray don't write
+     * to the same cache lines, except at worst at the boundary.
+     *
+     */
+    inline constexpr std::size_t PARALLEL_GRAIN = 64;
+}
+
+#endif /* ZIPPER_MODE_HPP */
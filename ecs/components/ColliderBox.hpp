@@ -1,8 +1,25 @@
 #ifndef COLLIDER_BOX_HPP
 #define COLLIDER_BOX_HPP
 
+#include <cstdint>
 #include "Rect.hpp"
 
+/**
+ * @brief The collision layers of the game. A collider
+ * box belongs to one or more layers and only collides
+ * with the boxes of the layers of its mask.
+ * 
+ */
+enum collisionLayer : std::uint32_t {
+  LAYER_NONE = 0,
+  LAYER_PLAYER = 1 << 0,
+  LAYER_PLAYER_BULLET = 1 << 1,
+  LAYER_ENEMY = 1 << 2,
+  LAYER_ENEMY_BULLET = 1 << 3,
+  LAYER_OBSTACLE = 1 << 4,
+  LAYER_ALL = 0xFFFFFFFF,
+};
+
 namespace Component
 {
   /**
@@ -16,6 +33,18 @@ namespace Component
      * 
      */
     Rect rect;
+    /**
+     * @brief The collisionLayer bits the box belongs to.
+     * 
+     */
+    std::uint32_t layer = LAYER_ALL;
+    /**
+     * @brief The collisionLayer bits the box collides with.
+     * Two boxes collide only if each one's layer is in the
+     * other's mask.
+     * 
+     */
+    std::uint32_t mask = LAYER_ALL;
   };
 }
 
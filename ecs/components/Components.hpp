@@ -2,11 +2,15 @@
 #define COMPONENTS_HPP
 
 #include "Transform.hpp"
+#include "PreviousTransform.hpp"
 #include "RigidBody.hpp"
 #include "ColliderBox.hpp"
 #include "Sprite.hpp"
 #include "Input.hpp"
 #include "Mortal.hpp"
 #include "Damage.hpp"
+#include "WorldBounds.hpp"
+#include "Interpolated.hpp"
+#include "Predicted.hpp"
 
 #endif /* COMPONENTS_HPP */
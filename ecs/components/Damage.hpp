@@ -1,7 +1,7 @@
 #ifndef DAMAGE_HPP
 #define DAMAGE_HPP
 
-#include "Components.hpp"
+#include "StoragePolicy.hpp"
 
 namespace Component
 {
@@ -11,4 +11,10 @@ namespace Component
     };
 }
 
+template <>
+struct StoragePolicy<Component::Damage>
+{
+    using type = DenseStorage;
+};
+
 #endif /* DAMAGE_HPP */
@@ -6,6 +6,7 @@
 #include "keyboard_input.hpp"
 #include "Event.hpp"
 #include <memory>
+#include "StoragePolicy.hpp"
 
 using action_map = std::map<keyboardInput, std::function<void ()>>;
 
@@ -26,4 +27,10 @@ namespace Component
     };
 }
 
+template <>
+struct StoragePolicy<Component::Input>
+{
+    using type = DenseStorage;
+};
+
 #endif /* INPUT_HPP */
\ No newline at end of file
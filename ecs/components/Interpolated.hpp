@@ -0,0 +1,117 @@
+#ifndef INTERPOLATED_HPP
+#define INTERPOLATED_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include "Transform.hpp"
+
+/**
+ * @brief The number of states an interpolated entity keeps,
+ * about half a second of snapshots at 30 Hz.
+ *
+ */
+#define INTERPOLATION_BUFFER_SIZE 16
+
+namespace Component
+{
+  /**
+   * @brief A Transform received at a given time.
+   *
+   */
+  struct InterpolationState
+  {
+    /**
+     * @brief The server time of the state, in seconds.
+     *
+     */
+    double time;
+    Transform transform;
+  };
+
+  /**
+   * @brief A component that holds the last received states of
+   * a remote entity, so it is rendered smoothly between them
+   * (see interpolation_system) instead of jumping at each
+   * snapshot.
+   *
+   */
+  struct Interpolated
+  {
+    /**
+     * @brief The ring buffer of states, by increasing time.
+     *
+     */
+    std::array<InterpolationState, INTERPOLATION_BUFFER_SIZE> states;
+    /**
+     * @brief The index of the oldest state.
+     *
+     */
+    std::size_t first;
+    std::size_t count;
+
+    /**
+     * @brief Add the newest state, overwriting the oldest one
+     * when the buffer is full. A state older than the newest
+     * one is ignored.
+     *
+     */
+    void push(double time, Transform const &transform)
+    {
+      if (count > 0 && time <= at(count - 1).time)
+        return;
+      if (count == INTERPOLATION_BUFFER_SIZE)
+      {
+        first = (first + 1) % INTERPOLATION_BUFFER_SIZE;
+        --count;
+      }
+      states[(first + count) % INTERPOLATION_BUFFER_SIZE] = InterpolationState{time, transform};
+      ++count;
+    }
+
+    /**
+     * @brief Get the Transform at a given time, interpolated
+     * between the states around it. Out of the buffered times,
+     * the oldest or newest state is held.
+     *
+     * @return false No state was received.
+     */
+    bool sample(double time, Transform &transform) const
+    {
+      if (count == 0)
+        return false;
+      if (time <= at(0).time)
+      {
+        transform = at(0).transform;
+        return true;
+      }
+      for (std::size_t i = 1; i < count; i++)
+      {
+        InterpolationState const &to = at(i);
+
+        if (time <= to.time)
+        {
+          InterpolationState const &from = at(i - 1);
+          float t = static_cast<float>((time - from.time) / (to.time - from.time));
+          // the rotation turns the shortest way
+          float turn = std::remainder(to.transform.rotation - from.transform.rotation, 360.0f);
+
+          transform.position = from.transform.position + (to.transform.position - from.transform.position) * t;
+          transform.scale = from.transform.scale + (to.transform.scale - from.transform.scale) * t;
+          transform.rotation = from.transform.rotation + turn * t;
+          return true;
+        }
+      }
+      transform = at(count - 1).transform;
+      return true;
+    }
+
+  private:
+    InterpolationState const &at(std::size_t i) const
+    {
+      return states[(first + i) % INTERPOLATION_BUFFER_SIZE];
+    }
+  };
+}
+
+#endif /* INTERPOLATED_HPP */
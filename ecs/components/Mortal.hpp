@@ -2,6 +2,7 @@
 #define MORTAL_HPP
 
 #include <cstddef>
+#include "StoragePolicy.hpp"
 
 namespace Component
 {
@@ -22,4 +23,10 @@ namespace Component
   };
 }
 
+template <>
+struct StoragePolicy<Component::Mortal>
+{
+  using type = DenseStorage;
+};
+
 #endif /* MORTAL_HPP */
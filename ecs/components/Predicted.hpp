@@ -0,0 +1,25 @@
+#ifndef PREDICTED_HPP
+#define PREDICTED_HPP
+
+#include "StoragePolicy.hpp"
+
+namespace Component
+{
+  /**
+   * @brief A tag for the local player of a client, moved by
+   * its net::Prediction only: the movement and physics systems
+   * skip it, so it isn't simulated twice per tick.
+   *
+   */
+  struct Predicted
+  {
+  };
+}
+
+template <>
+struct StoragePolicy<Component::Predicted>
+{
+  using type = DenseStorage;
+};
+
+#endif /* PREDICTED_HPP */
@@ -0,0 +1,41 @@
+#ifndef PREVIOUS_TRANSFORM_HPP
+#define PREVIOUS_TRANSFORM_HPP
+
+#include <cmath>
+#include "Transform.hpp"
+
+namespace Component
+{
+  /**
+   * @brief A component that holds the Transform of an entity
+   * before the last simulated tick, so a frame rendered between
+   * two ticks draws the entity between its previous and current
+   * Transform (see draw_system) instead of guessing ahead.
+   *
+   */
+  struct PreviousTransform
+  {
+    Transform transform;
+
+    /**
+     * @brief Get the Transform a fraction of tick after the
+     * previous one.
+     *
+     * @param current The Transform after the last tick.
+     * @param alpha The fraction of tick elapsed, from 0
+     * (the previous Transform) to 1 (the current one).
+     */
+    Transform lerp(Transform const &current, float alpha) const
+    {
+      // the rotation turns the shortest way
+      float turn = std::remainder(current.rotation - transform.rotation, 360.0f);
+
+      return Transform{
+        .position = transform.position + (current.position - transform.position) * alpha,
+        .rotation = transform.rotation + turn * alpha,
+        .scale = transform.scale + (current.scale - transform.scale) * alpha};
+    }
+  };
+}
+
+#endif /* PREVIOUS_TRANSFORM_HPP */
@@ -1,7 +1,6 @@
 #ifndef RIGIDBODY_HPP
 #define RIGIDBODY_HPP
 
-#include <SFML/System.hpp>
 #include "Vec2.hpp"
 
 namespace Component
@@ -32,13 +31,6 @@ namespace Component
      * 
      */
     Vec2 acceleration;
-    /**
-     * @brief the clock that will
-     * determin the refresh rate
-     * of the entity physics.
-     */
-    sf::Clock delta_clock_movement;
-    sf::Clock delta_clock_physics;
   };
 }
 
@@ -0,0 +1,31 @@
+#ifndef WORLD_BOUNDS_HPP
+#define WORLD_BOUNDS_HPP
+
+#include "StoragePolicy.hpp"
+
+namespace Component
+{
+  /**
+   * @brief A component that holds the world-space bounding
+   * box of an entity ColliderBox, scaled and centered on its
+   * Transform. It is computed once per frame by the bounds
+   * system, so the collision and debug systems read it instead
+   * of adjusting the ColliderBox again for every use.
+   * 
+   */
+  struct WorldBounds
+  {
+    float min_x;
+    float min_y;
+    float max_x;
+    float max_y;
+  };
+}
+
+template <>
+struct StoragePolicy<Component::WorldBounds>
+{
+  using type = DenseStorage;
+};
+
+#endif /* WORLD_BOUNDS_HPP */
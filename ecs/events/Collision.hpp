@@ -1,10 +1,38 @@
 #ifndef COLLISION_HPP
 #define COLLISION_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 namespace Events {
+    /**
+     * @brief Two entities whose collider boxes overlap.
+     * The entity indexes are ordered, entity_a is always
+     * the smallest one, and each one comes with the
+     * collisionLayer bits of its collider box.
+     *
+     */
+    struct Contact {
+        std::size_t entity_a;
+        std::size_t entity_b;
+        std::uint32_t layer_a;
+        std::uint32_t layer_b;
+    };
+
+    /**
+     * @brief Emitted once per frame by the collision system
+     * with every contact found during the frame. Each pair of
+     * entities is given once. The contacts are only valid
+     * during the receivers call.
+     *
+     */
     struct Collision {
-        Collision() {}
+        Collision(const std::vector<Contact> &contacts)
+        : contacts(contacts) {}
+
+        const std::vector<Contact> &contacts;
     };
 }
 
-#endif /* COLLISION_HPP */
\ No newline at end of file
+#endif /* COLLISION_HPP */
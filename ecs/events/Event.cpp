@@ -1,6 +1,6 @@
 #include "Event.hpp"
 
-BaseEvent::Family BaseEvent::family_counter = 0;
+std::atomic<BaseEvent::Family> BaseEvent::family_counter(0);
 
 BaseEvent::~BaseEvent()
 {
@@ -1,6 +1,7 @@
 #ifndef EVENT_HPP
 #define EVENT_HPP
 
+#include <atomic>
 #include <cstddef>
 
 class BaseEvent
@@ -16,9 +17,11 @@ protected:
      * It enable the event manager to notify
      * every event receivers when a event
      * of their corresponding type is emitted.
+     * It is shared by every registry, which may
+     * run on different threads.
      * 
      */
-    static Family family_counter;
+    static std::atomic<Family> family_counter;
 };
 
 /**
@@ -6,5 +6,7 @@
 #include "keyboard_input.hpp"
 #include "sfml_dict.hpp"
 #include "sfml_bouding_box.hpp"
+#include "aabb_overlap.hpp"
+#include "broad_phase.hpp"
 
 #endif /* HELPERS_HPP */
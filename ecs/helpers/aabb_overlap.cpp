@@ -0,0 +1,62 @@
+#include "aabb_overlap.hpp"
+
+#if AABB_OVERLAP_WIDTH == 8
+#include <immintrin.h>
+#elif AABB_OVERLAP_WIDTH == 4
+#include <emmintrin.h>
+#endif
+
+std::size_t overlap_batch(float min_x, float min_y, float max_x, float max_y, const AabbBatch &others, std::size_t count, std::uint32_t *hits)
+{
+    std::size_t found = 0;
+    std::size_t i = 0;
+
+#if AABB_OVERLAP_WIDTH == 8
+    const __m256 box_min_x = _mm256_set1_ps(min_x);
+    const __m256 box_min_y = _mm256_set1_ps(min_y);
+    const __m256 box_max_x = _mm256_set1_ps(max_x);
+    const __m256 box_max_y = _mm256_set1_ps(max_y);
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 overlap = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(box_min_x, _mm256_loadu_ps(others.max_x + i), _CMP_LE_OQ),
+                          _mm256_cmp_ps(_mm256_loadu_ps(others.min_x + i), box_max_x, _CMP_LE_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(box_min_y, _mm256_loadu_ps(others.max_y + i), _CMP_LE_OQ),
+                          _mm256_cmp_ps(_mm256_loadu_ps(others.min_y + i), box_max_y, _CMP_LE_OQ)));
+        int bits = _mm256_movemask_ps(overlap);
+
+        for (std::uint32_t lane = 0; bits != 0; lane++, bits >>= 1) {
+            if (bits & 1) {
+                hits[found++] = static_cast<std::uint32_t>(i) + lane;
+            }
+        }
+    }
+#elif AABB_OVERLAP_WIDTH == 4
+    const __m128 box_min_x = _mm_set1_ps(min_x);
+    const __m128 box_min_y = _mm_set1_ps(min_y);
+    const __m128 box_max_x = _mm_set1_ps(max_x);
+    const __m128 box_max_y = _mm_set1_ps(max_y);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 overlap = _mm_and_ps(
+            _mm_and_ps(_mm_cmple_ps(box_min_x, _mm_loadu_ps(others.max_x + i)),
+                       _mm_cmple_ps(_mm_loadu_ps(others.min_x + i), box_max_x)),
+            _mm_and_ps(_mm_cmple_ps(box_min_y, _mm_loadu_ps(others.max_y + i)),
+                       _mm_cmple_ps(_mm_loadu_ps(others.min_y + i), box_max_y)));
+        int bits = _mm_movemask_ps(overlap);
+
+        for (std::uint32_t lane = 0; bits != 0; lane++, bits >>= 1) {
+            if (bits & 1) {
+                hits[found++] = static_cast<std::uint32_t>(i) + lane;
+            }
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        if (min_x <= others.max_x[i] && others.min_x[i] <= max_x &&
+            min_y <= others.max_y[i] && others.min_y[i] <= max_y) {
+            hits[found++] = static_cast<std::uint32_t>(i);
+        }
+    }
+    return found;
+}
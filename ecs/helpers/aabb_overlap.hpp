@@ -0,0 +1,56 @@
+#ifndef AABB_OVERLAP_HPP
+#define AABB_OVERLAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief The number of boxes tested at once by
+ * overlap_batch(), 8 with AVX, 4 with SSE2 and 1
+ * without SIMD instructions (or when
+ * AABB_OVERLAP_NO_SIMD is defined).
+ * 
+ */
+#if defined(AABB_OVERLAP_NO_SIMD)
+#define AABB_OVERLAP_WIDTH 1
+#elif defined(__AVX__)
+#define AABB_OVERLAP_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AABB_OVERLAP_WIDTH 4
+#else
+#define AABB_OVERLAP_WIDTH 1
+#endif
+
+/**
+ * @brief The world bounds of a batch of boxes, stored as
+ * one array per coordinate so they can be loaded in SIMD
+ * registers. Every array has the same length.
+ * 
+ */
+struct AabbBatch
+{
+    const float *min_x;
+    const float *min_y;
+    const float *max_x;
+    const float *max_y;
+};
+
+/**
+ * @brief Test a box against a batch of boxes and give the
+ * index of every box it overlaps, with the same rules as
+ * isCollision() (the edges are included). The boxes are
+ * tested AABB_OVERLAP_WIDTH at a time.
+ * 
+ * @param min_x The left of the box.
+ * @param min_y The top of the box.
+ * @param max_x The right of the box.
+ * @param max_y The bottom of the box.
+ * @param others The bounds of the batch.
+ * @param count The number of boxes of the batch.
+ * @param hits The indexes of the overlapping boxes in the
+ * batch, in increasing order. It must hold count indexes.
+ * @return std::size_t The number of overlapping boxes.
+ */
+std::size_t overlap_batch(float min_x, float min_y, float max_x, float max_y, const AabbBatch &others, std::size_t count, std::uint32_t *hits);
+
+#endif /* AABB_OVERLAP_HPP */
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include "broad_phase.hpp"
+#include "aabb_overlap.hpp"
+
+/**
+ * @brief The colliders of a layer, a range of the
+ * sorted proxies.
+ * 
+ */
+struct LayerGroup
+{
+    std::size_t begin;
+    std::size_t end;
+    std::uint32_t layer;
+    /**
+     * @brief The union of the masks of the colliders.
+     * 
+     */
+    std::uint32_t mask;
+};
+
+/**
+ * @brief The bounds of the sorted proxies, one array per
+ * coordinate for overlap_batch().
+ * 
+ */
+struct ProxyBounds
+{
+    std::vector<float> min_x;
+    std::vector<float> min_y;
+    std::vector<float> max_x;
+    std::vector<float> max_y;
+    std::vector<std::uint32_t> hits;
+};
+
+bool doesInteract(const BroadPhaseProxy &lhs, const BroadPhaseProxy &rhs)
+{
+    return (lhs.layer & rhs.mask) && (rhs.layer & lhs.mask);
+}
+
+/**
+ * @brief Test a proxy against the proxies [begin, end) at
+ * once and keep the overlapping ones that interact with it.
+ * 
+ */
+static void overlap_range(const std::vector<BroadPhaseProxy> &proxies, ProxyBounds &bounds, std::size_t i, std::size_t begin, std::size_t end, std::vector<std::pair<std::size_t, std::size_t>> &pairs)
+{
+    if (begin >= end) {
+        return;
+    }
+    AabbBatch batch{bounds.min_x.data() + begin, bounds.min_y.data() + begin, bounds.max_x.data() + begin, bounds.max_y.data() + begin};
+    std::size_t found = overlap_batch(bounds.min_x[i], bounds.min_y[i], bounds.max_x[i], bounds.max_y[i], batch, end - begin, bounds.hits.data());
+
+    for (std::size_t h = 0; h < found; h++) {
+        const BroadPhaseProxy &other = proxies[begin + bounds.hits[h]];
+
+        if (doesInteract(proxies[i], other)) {
+            pairs.emplace_back(proxies[i].entity, other.entity);
+        }
+    }
+}
+
+/**
+ * @brief Get the end of the proxies of a group that start
+ * before or at a position on the x axis.
+ * 
+ */
+static std::size_t starting_before(const ProxyBounds &bounds, const LayerGroup &group, std::size_t from, float x)
+{
+    return std::upper_bound(bounds.min_x.begin() + from, bounds.min_x.begin() + group.end, x) - bounds.min_x.begin();
+}
+
+static void sweep_group(const std::vector<BroadPhaseProxy> &proxies, ProxyBounds &bounds, const LayerGroup &group, std::vector<std::pair<std::size_t, std::size_t>> &pairs)
+{
+    for (std::size_t i = group.begin; i < group.end; i++) {
+        overlap_range(proxies, bounds, i, i + 1, starting_before(bounds, group, i + 1, bounds.max_x[i]), pairs);
+    }
+}
+
+/**
+ * @brief Pair the colliders of two groups that overlap. A
+ * pair is found from the collider that starts first on the
+ * x axis, the ties going to the first group.
+ * 
+ */
+static void sweep_groups(const std::vector<BroadPhaseProxy> &proxies, ProxyBounds &bounds, const LayerGroup &lhs, const LayerGroup &rhs, std::vector<std::pair<std::size_t, std::size_t>> &pairs)
+{
+    std::size_t first = rhs.begin;
+
+    for (std::size_t i = lhs.begin; i < lhs.end; i++) {
+        for (; first < rhs.end && bounds.min_x[first] < bounds.min_x[i]; first++);
+        overlap_range(proxies, bounds, i, first, starting_before(bounds, rhs, first, bounds.max_x[i]), pairs);
+    }
+    first = lhs.begin;
+    for (std::size_t j = rhs.begin; j < rhs.end; j++) {
+        for (; first < lhs.end && bounds.min_x[first] <= bounds.min_x[j]; first++);
+        overlap_range(proxies, bounds, j, first, starting_before(bounds, lhs, first, bounds.max_x[j]), pairs);
+    }
+}
+
+void sweep_and_prune(std::vector<BroadPhaseProxy> &proxies, std::vector<std::pair<std::size_t, std::size_t>> &pairs)
+{
+    // kept from one call to the next to reuse their memory
+    static thread_local ProxyBounds bounds;
+    static thread_local std::vector<LayerGroup> groups;
+
+    pairs.clear();
+    groups.clear();
+    std::sort(proxies.begin(), proxies.end(), [](const BroadPhaseProxy &lhs, const BroadPhaseProxy &rhs) {
+        return (lhs.layer != rhs.layer ? lhs.layer < rhs.layer : lhs.min_x < rhs.min_x);
+    });
+    bounds.min_x.resize(proxies.size());
+    bounds.min_y.resize(proxies.size());
+    bounds.max_x.resize(proxies.size());
+    bounds.max_y.resize(proxies.size());
+    bounds.hits.resize(proxies.size());
+    for (std::size_t i = 0; i < proxies.size(); i++) {
+        bounds.min_x[i] = proxies[i].min_x;
+        bounds.min_y[i] = proxies[i].min_y;
+        bounds.max_x[i] = proxies[i].max_x;
+        bounds.max_y[i] = proxies[i].max_y;
+        if (groups.empty() || groups.back().layer != proxies[i].layer) {
+            groups.push_back(LayerGroup{i, i, proxies[i].layer, 0});
+        }
+        groups.back().end = i + 1;
+        groups.back().mask |= proxies[i].mask;
+    }
+    for (std::size_t g = 0; g < groups.size(); g++) {
+        if (groups[g].layer & groups[g].mask) {
+            sweep_group(proxies, bounds, groups[g], pairs);
+        }
+        for (std::size_t h = g + 1; h < groups.size(); h++) {
+            if ((groups[g].layer & groups[h].mask) && (groups[h].layer & groups[g].mask)) {
+                sweep_groups(proxies, bounds, groups[g], groups[h], pairs);
+            }
+        }
+    }
+}
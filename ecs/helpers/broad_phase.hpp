@@ -0,0 +1,71 @@
+#ifndef BROAD_PHASE_HPP
+#define BROAD_PHASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The world bounds of an entity collider given
+ * to the collision broad-phase.
+ * 
+ */
+struct BroadPhaseProxy
+{
+  /**
+   * @brief The entity index of the collider.
+   * 
+   */
+  std::size_t entity;
+  float min_x;
+  float min_y;
+  float max_x;
+  float max_y;
+  /**
+   * @brief The collisionLayer bits of the collider.
+   * 
+   */
+  std::uint32_t layer;
+  /**
+   * @brief The collisionLayer bits the collider collides with.
+   * 
+   */
+  std::uint32_t mask;
+};
+
+/**
+ * @brief Indicate if two colliders layers and masks let
+ * them collide, each one's layer must be in the other's
+ * mask.
+ * 
+ * @param lhs The first collider.
+ * @param rhs The second collider.
+ * @return true The colliders can collide.
+ * @return false The colliders never collide.
+ */
+bool doesInteract(const BroadPhaseProxy &lhs, const BroadPhaseProxy &rhs);
+
+/**
+ * @brief Find the colliders that overlap. The colliders
+ * are sorted along the x axis (sweep and prune) and each
+ * one is only tested against the colliders whose x range
+ * overlaps its own, which suits the horizontal scrolling
+ * of the game. These candidates are contiguous once sorted,
+ * so they are tested several at a time by overlap_batch()
+ * (the narrow-phase). The cost grows with n log n colliders
+ * and the number of candidates, instead of with the square
+ * of the number of colliders.
+ * The colliders are first grouped by layer, and two
+ * groups whose layers and masks never interact aren't
+ * swept at all (e.g. bullets against bullets).
+ * 
+ * @param proxies The colliders bounds, sorted by layer
+ * and then by min_x by the function.
+ * @param pairs The pairs of entity indexes whose colliders
+ * overlap and interact, each unordered pair is given once.
+ * The vector is cleared first.
+ */
+void sweep_and_prune(std::vector<BroadPhaseProxy> &proxies, std::vector<std::pair<std::size_t, std::size_t>> &pairs);
+
+#endif /* BROAD_PHASE_HPP */
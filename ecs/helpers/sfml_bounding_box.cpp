@@ -12,10 +12,10 @@ bool doesContain(const Rect &r, const Vec2 p)
 }
 
 bool isCollision(const Rect &r, const Rect &other_r) {
-    return (doesContain(other_r, r.left) ||
-            doesContain(other_r, r.top) ||
-            doesContain(other_r, r.left + r.width) ||
-            doesContain(other_r, r.top + r.height));
+    return (r.left <= other_r.left + other_r.width &&
+            other_r.left <= r.left + r.width &&
+            r.top <= other_r.top + other_r.height &&
+            other_r.top <= r.top + r.height);
 }
 
 Rect get_adjusted_rect(Component::ColliderBox &box, Component::Transform &tf)
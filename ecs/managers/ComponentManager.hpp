@@ -1,13 +1,13 @@
 #ifndef COMPONENT_MANAGER_HPP
 #define COMPONENT_MANAGER_HPP
 
-#include <any>
-#include <typeindex>
-#include <typeinfo>
-#include <unordered_map>
-#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 #include "Entity.hpp"
 #include "SparseArray.hpp"
+#include "ComponentFamily.hpp"
+#include "ComponentPool.hpp"
 
 /**
  * @brief Handles all the components of the
@@ -22,6 +22,9 @@ public:
 
     /**
      * @brief Add a new type of components to the game engine.
+     * If the type is already registered, its sparse array is
+     * returned untouched, so the entity signatures and the views
+     * stay consistent with it.
      * 
      * @tparam Component The new components type to be added.
      * @return SparseArray<Component>& A reference to the newly
@@ -54,19 +57,22 @@ public:
     SparseArray<Component> const &get_components() const;
 
     /**
-     * @brief A map that stores all the destructor function of the
-     * components type of the game engine.
+     * @brief Detach every component of a batch of entities,
+     * visiting each registered component pool once.
      * 
+     * @param ids The ids of the entities. An entity without
+     * a component of a type is skipped by its pool.
      */
-    std::unordered_map<std::type_index, std::function<void(Entity const &)>> _erase_component_functions_array;
+    void erase_batch(std::vector<std::size_t> const &ids);
 
 private:
     /**
-     * @brief A map that stores all the type of components in the
-     * game engine.
+     * @brief All the component pools of the game engine,
+     * indexed by component family. A family that isn't
+     * registered holds a nullptr.
      * 
      */
-    std::unordered_map<std::type_index, std::any> _components_array;
+    std::vector<std::unique_ptr<BaseComponentPool>> _pools;
 };
 
 inline ComponentManager::ComponentManager()
@@ -80,24 +86,44 @@ inline ComponentManager::~ComponentManager()
 template <class Component>
 inline SparseArray<Component> &ComponentManager::register_component()
 {
-    _components_array[std::type_index(typeid(Component))] = SparseArray<Component>();
-    _erase_component_functions_array[std::type_index(typeid(Component))] = [this](Entity const &e)
-    {
-        this->get_components<Component>().erase(e);
-    };
+    std::size_t family = ComponentFamily<Component>::family();
+
+    if (family >= MAX_COMPONENTS)
+        throw std::runtime_error("Too many component types registered");
+    if (family >= _pools.size())
+        _pools.resize(family + 1);
+    if (!_pools[family])
+        _pools[family] = std::make_unique<ComponentPool<Component>>();
     return get_components<Component>();
 }
 
 template <class Component>
 inline SparseArray<Component> &ComponentManager::get_components()
 {
-    return std::any_cast<SparseArray<Component> &>(_components_array[std::type_index(typeid(Component))]);
+    std::size_t family = ComponentFamily<Component>::family();
+
+    if (family >= _pools.size() || !_pools[family])
+        throw std::runtime_error("Component is not registered");
+    return static_cast<ComponentPool<Component> &>(*_pools[family])._components;
 }
 
 template <class Component>
 inline SparseArray<Component> const &ComponentManager::get_components() const
 {
-    return std::any_cast<SparseArray<Component> const &>(_components_array.at(std::type_index(typeid(Component))));
+    std::size_t family = ComponentFamily<Component>::family();
+
+    if (family >= _pools.size() || !_pools[family])
+        throw std::runtime_error("Component is not registered");
+    return static_cast<ComponentPool<Component> const &>(*_pools[family])._components;
+}
+
+inline void ComponentManager::erase_batch(std::vector<std::size_t> const &ids)
+{
+    for (auto &pool : _pools)
+    {
+        if (pool)
+            pool->erase_batch(ids);
+    }
 }
 
 #endif /* COMPONENT_MANAGER_HPP */
@@ -1,8 +1,14 @@
 #ifndef ENTITYMANAGER_HPP
 #define ENTITYMANAGER_HPP
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
 #include <queue>
+#include <stdexcept>
+#include <vector>
 #include "ComponentManager.hpp"
+#include "View.hpp"
 
 /**
  * @brief Handles all the entities of the
@@ -32,12 +38,66 @@ public:
      */
     Entity entity_from_index(std::size_t index);
     /**
-     * @brief Remove an entity from the game engine.
+     * @brief Rebuild an entity from its handle (e.g. received
+     * over the network). The entity isn't checked, use
+     * is_alive() before using it.
+     * 
+     * @param handle The handle of the expected entity.
+     * @return Entity The entity corresponding to the handle.
+     */
+    Entity entity_from_handle(Entity::handle_type handle);
+    /**
+     * @brief Indicate if an entity is still in the game
+     * engine, in constant time. An entity copied before
+     * being killed is never alive again, even when its
+     * id is reused by a new entity.
+     * 
+     * @param e The entity.
+     * @return true The entity is alive.
+     * @return false The entity was killed or never spawned.
+     */
+    bool is_alive(Entity const &e) const;
+    /**
+     * @brief Queue an entity to be removed from the game
+     * engine by the next flush_killed_entities() call. The
+     * entity stays alive until then, so systems can kill
+     * entities while iterating their components. Nothing
+     * is done if the entity isn't alive anymore or is
+     * already queued. It can be called by systems running
+     * at the same time.
      * 
-     * @param c_m The components manager of the game engine.
      * @param e The entity to be removed.
      */
-    void kill_entity(ComponentManager &c_m, Entity const &e);
+    void kill_entity(Entity const &e);
+    /**
+     * @brief Remove every queued entity from the game engine.
+     * The killed entities are detached from every registered
+     * component pool, each pool being visited once per flush,
+     * so a component inserted straight in its SparseArray
+     * doesn't outlive its entity.
+     * Entities are removed by increasing index whatever
+     * order they were killed in, so the ids given to the
+     * next spawned entities don't depend on how the
+     * systems were scheduled.
+     * 
+     * @param c_m The components manager of the game engine.
+     */
+    void flush_killed_entities(ComponentManager &c_m);
+
+    /**
+     * @brief Get the view of the entities that have every
+     * component family of a mask attached. The view is
+     * created, and filled with the existing entities, the
+     * first time the mask is asked. It is then shared by
+     * everyone asking for the same mask and stays valid
+     * as long as the entity manager.
+     * 
+     * @param mask The component families required.
+     * @param excluded The component families the entities
+     * of the view must not have attached.
+     * @return View& A reference to the view.
+     */
+    View &get_view(Signature const &mask, Signature const &excluded = Signature());
 
     /**
      * @brief Get a component reference of a specific type from a specific
@@ -87,7 +147,8 @@ public:
      * @tparam Component The type of the component which will be attached.
      * It must be already registered in the game engine.
      * @param c_m The component manager of the game engine.
-     * @param e The entity to be attached to.
+     * @param e The entity to be attached to. It must be alive,
+     * a std::runtime_error is thrown otherwise.
      * @param c The component to be attached.
      * @return SparseArray<Component>::reference_type A reference
      * to the attached components in its component type sparse array.
@@ -113,7 +174,8 @@ public:
      * @tparam Component The type of the component which will be attached.
      * It must be already registered in the game engine.
      * @param c_m The component manager of the game engine.
-     * @param e The entity to be attached to.
+     * @param e The entity to be attached to. It must be alive,
+     * a std::runtime_error is thrown otherwise.
      * @param p The constructor parameters of the components to be attached.
      * @return SparseArray<Component>::reference_type A reference
      * to the attached components in its component type sparse array.
@@ -133,6 +195,14 @@ public:
     void remove_component(ComponentManager &, Entity const &);
 
 private:
+    /**
+     * @brief Update every view after a change of the
+     * signature of an entity.
+     * 
+     * @param e The entity index.
+     */
+    void update_views(std::size_t e);
+
     /**
      * @brief The index (also called id) of the last
      * created entity.
@@ -145,11 +215,63 @@ private:
      * 
      */
     std::queue<std::size_t> _dead_entities_id;
+    /**
+     * @brief The current generation of each entity
+     * index. It is incremented when the entity is
+     * killed.
+     * 
+     */
+    std::vector<Entity::generation_type> _generations;
+    /**
+     * @brief Indicate if each entity index is
+     * currently used by an entity.
+     * 
+     */
+    std::vector<bool> _alive;
+    /**
+     * @brief The component families attached to each
+     * entity index through add_component(),
+     * emplace_component() and remove_component().
+     * A component inserted straight in its SparseArray
+     * isn't in the signature, so the views don't see it,
+     * but it is still detached when the entity is killed.
+     * 
+     */
+    std::vector<Signature> _signatures;
+    /**
+     * @brief The indexes of the entities queued by
+     * kill_entity().
+     * 
+     */
+    std::vector<std::size_t> _killed_entities_id;
+    /**
+     * @brief Indicate if each entity index is already
+     * queued by kill_entity().
+     * 
+     */
+    std::vector<bool> _killed;
+    /**
+     * @brief Protects the kill queue.
+     * 
+     */
+    std::mutex _killed_mutex;
+    /**
+     * @brief Every view created by get_view().
+     * 
+     */
+    std::vector<std::unique_ptr<View>> _views;
 };
 
 inline EntityManager::EntityManager()
     : _last_registered_entity_id(0),
-      _dead_entities_id()
+      _dead_entities_id(),
+      _generations(),
+      _alive(),
+      _signatures(),
+      _killed_entities_id(),
+      _killed(),
+      _killed_mutex(),
+      _views()
 {
 }
 
@@ -160,25 +282,86 @@ inline EntityManager::~EntityManager()
 inline Entity EntityManager::spawn_entity()
 {
     if (_dead_entities_id.empty())
+    {
+        _generations.push_back(0);
+        _alive.push_back(true);
+        _signatures.emplace_back();
+        _killed.push_back(false);
         return entity_from_index(_last_registered_entity_id++);
+    }
     std::size_t id = _dead_entities_id.front();
 
     _dead_entities_id.pop();
+    _alive[id] = true;
     return entity_from_index(id);
 }
 
 inline Entity EntityManager::entity_from_index(std::size_t idx)
 {
-    return Entity(idx);
+    return Entity(idx, (idx < _generations.size() ? _generations[idx] : 0));
 }
 
-inline void EntityManager::kill_entity(ComponentManager &c_m, Entity const &e)
+inline Entity EntityManager::entity_from_handle(Entity::handle_type handle)
 {
-    for (auto &f : c_m._erase_component_functions_array)
+    return Entity(handle);
+}
+
+inline bool EntityManager::is_alive(Entity const &e) const
+{
+    std::size_t idx = e;
+
+    return (idx < _alive.size()) && _alive[idx] && (_generations[idx] == e.get_generation());
+}
+
+inline void EntityManager::kill_entity(Entity const &e)
+{
+    std::lock_guard<std::mutex> lock(_killed_mutex);
+
+    if (!is_alive(e) || _killed[e])
+        return;
+    _killed[e] = true;
+    _killed_entities_id.push_back(e);
+}
+
+inline void EntityManager::flush_killed_entities(ComponentManager &c_m)
+{
+    if (_killed_entities_id.empty())
+        return;
+    std::sort(_killed_entities_id.begin(), _killed_entities_id.end());
+    c_m.erase_batch(_killed_entities_id);
+    for (std::size_t id : _killed_entities_id)
+    {
+        _signatures[id].reset();
+        update_views(id);
+        _killed[id] = false;
+        _alive[id] = false;
+        ++_generations[id];
+        _dead_entities_id.push(id);
+    }
+    _killed_entities_id.clear();
+}
+
+inline View &EntityManager::get_view(Signature const &mask, Signature const &excluded)
+{
+    for (auto &view : _views)
     {
-        f.second(e);
+        if ((view->get_mask() == mask) && (view->get_excluded() == excluded))
+            return *view;
     }
-    _dead_entities_id.push(e);
+    View &view = *_views.emplace_back(std::make_unique<View>(mask, excluded));
+
+    for (std::size_t id = 0; id < _signatures.size(); id++)
+    {
+        if (_alive[id])
+            view.update(id, _signatures[id]);
+    }
+    return view;
+}
+
+inline void EntityManager::update_views(std::size_t e)
+{
+    for (auto &view : _views)
+        view->update(e, _signatures[e]);
 }
 
 template <typename Component>
@@ -198,19 +381,33 @@ bool EntityManager::has_component(ComponentManager &c_m, Entity e)
 template <class Component>
 inline typename SparseArray<Component>::reference_type EntityManager::add_component(ComponentManager &c_m, Entity const &to, Component &&c)
 {
-    return c_m.get_components<Component>().insert_at(to, std::forward<Component>(c));
+    if (!is_alive(to))
+        throw std::runtime_error("Component attached to a dead entity");
+    typename SparseArray<Component>::reference_type component = c_m.get_components<Component>().insert_at(to, std::forward<Component>(c));
+
+    _signatures[to].set(ComponentFamily<Component>::family());
+    update_views(to);
+    return component;
 }
 
 template <class Component, class... Params>
 inline typename SparseArray<Component>::reference_type EntityManager::emplace_component(ComponentManager &c_m, Entity const &to, Params &&...p)
 {
-    return c_m.get_components<Component>().emplace_at(to, std::forward<Params>(p)...);
+    if (!is_alive(to))
+        throw std::runtime_error("Component attached to a dead entity");
+    typename SparseArray<Component>::reference_type component = c_m.get_components<Component>().emplace_at(to, std::forward<Params>(p)...);
+
+    _signatures[to].set(ComponentFamily<Component>::family());
+    update_views(to);
+    return component;
 }
 
 template <class Component>
 inline void EntityManager::remove_component(ComponentManager &c_m, Entity const &from)
 {
     c_m.get_components<Component>().erase(from);
+    _signatures[from].reset(ComponentFamily<Component>::family());
+    update_views(from);
 }
 
 #endif /* ENTITYMANAGER_HPP */
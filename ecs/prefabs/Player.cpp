@@ -4,25 +4,49 @@
 #include <cmath>
 #include <iostream>
 
+/**
+ * @brief Accelerate the player entity if it is still alive.
+ * The actions capture the entity instead of a reference
+ * to its RigidBody, which would dangle once the sparse
+ * array grows or the entity is killed.
+ *
+ */
+static void accelerate(Registry &r, Entity const &e, Vec2 const &acceleration)
+{
+    SparseArray<Component::RigidBody> &rigid_bodies = r.get_components<Component::RigidBody>();
+
+    if (r.is_alive(e) && rigid_bodies.doesContain(e)) {
+        rigid_bodies[e]->acceleration += acceleration;
+    }
+}
+
+action_map Prefab::Player::actions(Registry &r, Entity const &e)
+{
+    action_map actions;
+
+    actions[KEY_UP] = [&r, e](){ accelerate(r, e, Vec2{0, -PLAYER_BASE_ACCELERATION}); };
+    actions[KEY_LEFT] = [&r, e](){ accelerate(r, e, Vec2{-PLAYER_BASE_ACCELERATION, 0}); };
+    actions[KEY_DOWN] = [&r, e](){ accelerate(r, e, Vec2{0, PLAYER_BASE_ACCELERATION}); };
+    actions[KEY_RIGHT] = [&r, e](){ accelerate(r, e, Vec2{PLAYER_BASE_ACCELERATION, 0}); };
+    return actions;
+}
+
 Prefab::Player::Player(Registry &r, Component::Transform &&transform, Component::RigidBody &&rigid_body)
+    : entity(r.spawn_entity())
 {
-    auto e = r.spawn_entity();
+    Entity const &e = entity;
 
+    r.add_component(e, Component::PreviousTransform{.transform = transform});
     r.add_component(e, std::forward<Component::Transform>(transform));
-    auto &physics = *r.add_component<Component::RigidBody>(e, std::forward<Component::RigidBody>(rigid_body));
+    r.add_component<Component::RigidBody>(e, std::forward<Component::RigidBody>(rigid_body));
     r.add_component(e,
-        Component::ColliderBox{.rect = Rect(0, 0, 32, 32)});
+        Component::ColliderBox{.rect = Rect(0, 0, 32, 32), .layer = LAYER_PLAYER, .mask = LAYER_ENEMY | LAYER_ENEMY_BULLET | LAYER_OBSTACLE});
+    r.add_component(e, Component::WorldBounds{});
     r.add_component(e,
         Component::Sprite{.texture_name = "player.png"});
     r.add_component(e,
         Component::Mortal{.health_points = 100});
-    action_map actions;
-    actions[KEY_UP] = [&physics](){ physics.acceleration += Vec2{0, -PLAYER_BASE_ACCELERATION}; };
-    actions[KEY_LEFT] = [&physics](){ physics.acceleration += Vec2{-PLAYER_BASE_ACCELERATION, 0}; };
-    actions[KEY_DOWN] = [&physics](){ physics.acceleration += Vec2{0, PLAYER_BASE_ACCELERATION}; };
-    actions[KEY_RIGHT] = [&physics](){ physics.acceleration += Vec2{PLAYER_BASE_ACCELERATION, 0}; };
-
-    r.add_component(e, Component::Input{.actions = actions});
+    r.add_component(e, Component::Input{.actions = actions(r, e)});
 
     // r.add_component(e, Component::BoxCollider{});
     // r.add_component(e, Component::Sprite{.sprite = sf::Sprite(r.get_system_manager()._texture_manager.get_resource("player.png"))});
@@ -2,6 +2,7 @@
 #define PLAYER_HPP
 
 #include "Components.hpp"
+#include "Entity.hpp"
 #include "Helpers.hpp"
 
 class Registry;
@@ -13,6 +14,20 @@ namespace Prefab
     struct Player
     {
         Player(Registry &, Component::Transform &&, Component::RigidBody &&);
+
+        /**
+         * @brief The spawned player entity.
+         *
+         */
+        Entity entity;
+
+        /**
+         * @brief Get the actions moving a player entity, e.g.
+         * to predict the local player on a client the same way
+         * the server moves it.
+         *
+         */
+        static action_map actions(Registry &, Entity const &);
     };
 }
 
@@ -9,6 +9,7 @@
 #include "SparseArray.hpp"
 #include "Zipper.hpp"
 #include "IndexedZipper.hpp"
+#include "View.hpp"
 #include "Event.hpp"
 #include "Events.hpp"
 
@@ -16,22 +17,45 @@ class Registry;
 
 namespace System
 {
+    void previous_transform_system(Registry &,
+                                   View const &,
+                                   SparseArray<Component::Transform> &,
+                                   SparseArray<Component::PreviousTransform> &);
+
     void movement_system(Registry &,
+                         View const &,
                          SparseArray<Component::Transform> &,
                          SparseArray<Component::RigidBody> &);
 
     void physics_system(Registry &r,
+                                View const &view,
                                 SparseArray<Component::RigidBody> &rigid_bodies);
 
+    void interpolation_system(Registry &,
+                              View const &,
+                              SparseArray<Component::Transform> &,
+                              SparseArray<Component::PreviousTransform> &,
+                              SparseArray<Component::Interpolated> &);
+
     void draw_system(Registry &,
+                     View const &,
                      SparseArray<Component::Transform> &,
+                     SparseArray<Component::PreviousTransform> &,
                      SparseArray<Component::Sprite> &);
 
     void input_system(Registry &r,
+                      View const &view,
                       SparseArray<Component::Input> &inputs);
 
+    void bounds_system(Registry &r,
+                       View const &view,
+                       SparseArray<Component::Transform> &transforms,
+                       SparseArray<Component::ColliderBox> &boxes,
+                       SparseArray<Component::WorldBounds> &bounds);
+
     void collision_system(Registry &r,
-                          SparseArray<Component::Transform> &transforms,
+                          View const &view,
+                          SparseArray<Component::WorldBounds> &bounds,
                           SparseArray<Component::ColliderBox> &boxes);
 
     // void collision_system(Registry &,
@@ -43,18 +67,17 @@ namespace System
     //   SparseArray<Component::Obstacle> &);</Component::Obstacle>
 
     void kill_system(Registry &,
+                     View const &,
                      SparseArray<Component::Mortal> &);
 
     void debug_system(Registry &r,
-                      SparseArray<Component::Transform> &transforms,
-                      SparseArray<Component::ColliderBox> &collider_boxes);
+                      View const &view,
+                      SparseArray<Component::WorldBounds> &bounds);
 }
 
 namespace Receiver
 {
     void configure_camera(const Events::CameraConfig &e);
-
-    void collision_receiver(const Events::Collision &e);
 }
 
 #endif /* SYSTEMS_HPP */
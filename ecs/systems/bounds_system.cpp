@@ -0,0 +1,16 @@
+#include "Registry.hpp"
+#include "Helpers.hpp"
+
+void System::bounds_system(Registry &r,
+                           View const &view,
+                           SparseArray<Component::Transform> &transforms,
+                           SparseArray<Component::ColliderBox> &boxes,
+                           SparseArray<Component::WorldBounds> &bounds)
+{
+    containers::Zipper(view, transforms, boxes, bounds).parallel_each(r.get_thread_pool(), [](Component::Transform &tf, Component::ColliderBox &box, Component::WorldBounds &bds)
+    {
+        Rect rect = get_adjusted_rect(box, tf);
+
+        bds = Component::WorldBounds{rect.left, rect.top, rect.left + rect.width, rect.top + rect.height};
+    });
+}
@@ -3,22 +3,28 @@
 #include "Events.hpp"
 
 void System::collision_system(Registry &r,
-                        SparseArray<Component::Transform> &transforms,
+                        View const &view,
+                        SparseArray<Component::WorldBounds> &bounds,
                         SparseArray<Component::ColliderBox> &boxes)
 {
-    for (auto &&[idx, tf, box] : containers::IndexedZipper(transforms, boxes)) {
-        for (auto &&[other_idx, other_tf, other_box] : containers::IndexedZipper(idx, transforms, boxes)) {
-            if (idx == other_idx) {
-                continue;
-            }
-            if (isCollision(get_adjusted_rect(box, tf), get_adjusted_rect(other_box, other_tf))) {
-                r._event_manager->emit<Events::Collision>();
-            }
+    // one set of buffers per thread, registries of other rooms may run at the same time
+    static thread_local std::vector<BroadPhaseProxy> proxies;
+    static thread_local std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    static thread_local std::vector<Events::Contact> contacts;
+
+    proxies.clear();
+    contacts.clear();
+    for (auto &&[idx, bds, box] : containers::IndexedZipper(view, bounds, boxes)) {
+        proxies.push_back(BroadPhaseProxy{idx, bds.min_x, bds.min_y, bds.max_x, bds.max_y, box.layer, box.mask});
+    }
+    sweep_and_prune(proxies, pairs);
+    for (auto [idx, other_idx] : pairs) {
+        if (idx > other_idx) {
+            std::swap(idx, other_idx);
         }
+        contacts.push_back(Events::Contact{idx, other_idx, boxes.component_at(idx).layer, boxes.component_at(other_idx).layer});
+    }
+    if (!contacts.empty()) {
+        r._event_manager->emit<Events::Collision>(contacts);
     }
 }
-
-void Receiver::collision_receiver(const Events::Collision &e)
-{
-    std::cout << "COLLISION" << std::endl;
-}
\ No newline at end of file
@@ -2,17 +2,15 @@
 #include "Systems.hpp"
 
 void System::debug_system(Registry &r,
-                        SparseArray<Component::Transform> &transforms,
-                        SparseArray<Component::ColliderBox> &boxes)
+                        View const &view,
+                        SparseArray<Component::WorldBounds> &bounds)
 {
-    for (auto &&[tf, box] : containers::Zipper(transforms, boxes))
+    for (auto &&[bds] : containers::Zipper(view, bounds))
     {
         sf::RectangleShape tmp;
         
-        tmp.setPosition(tf.position.x - box.rect.left, tf.position.y - box.rect.top);
-        tmp.setOrigin(box.rect.width / 2, box.rect.height / 2);
-        tmp.setSize(sf::Vector2f{box.rect.width, box.rect.height});
-        tmp.setScale(tf.scale.x, tf.scale.y);
+        tmp.setPosition(bds.min_x, bds.min_y);
+        tmp.setSize(sf::Vector2f{bds.max_x - bds.min_x, bds.max_y - bds.min_y});
         tmp.setOutlineColor(sf::Color::Blue);
         tmp.setOutlineThickness(1.0f);
         tmp.setFillColor(sf::Color::Transparent);
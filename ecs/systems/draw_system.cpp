@@ -3,21 +3,28 @@
 #include "Events.hpp"
 
 void System::draw_system(Registry &r,
+                         View const &view,
                          SparseArray<Component::Transform> &transforms,
+                         SparseArray<Component::PreviousTransform> &previous,
                          SparseArray<Component::Sprite> &sprites)
 {
-    for (auto &&[tf, sprite] : containers::Zipper(transforms, sprites))
+    // the frame is rendered between the last two simulated ticks,
+    // by the fraction of tick elapsed since the last one
+    float alpha = r.get_timestep().get_alpha();
+
+    for (auto &&[tf, prev, sprite] : containers::Zipper(view, transforms, previous, sprites))
     {
         sf::Sprite tmp;
         sf::IntRect rect;
+        Component::Transform drawn = prev.lerp(tf, alpha);
 
         tmp.setTexture(r.get_system_manager()._texture_manager.get_resource(sprite.texture_name));
         rect = tmp.getTextureRect();
 
-        tmp.setPosition(tf.position.x, tf.position.y);
+        tmp.setPosition(drawn.position.x, drawn.position.y);
         tmp.setOrigin(rect.width / 2, rect.height / 2);
-        tmp.setScale(tf.scale.x, tf.scale.y);
-        tmp.setRotation(tf.rotation);
+        tmp.setScale(drawn.scale.x, drawn.scale.y);
+        tmp.setRotation(drawn.rotation);
         r.get_system_manager()._window.draw(tmp);
     }
 }
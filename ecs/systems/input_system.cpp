@@ -1,9 +1,9 @@
 #include "Registry.hpp"
 #include "Helpers.hpp"
 
-static void trigger_action(SparseArray<Component::Input> &inputs, keyboardInput pressed_key)
+static void trigger_action(View const &view, SparseArray<Component::Input> &inputs, keyboardInput pressed_key)
 {
-    for (auto &&[input] : containers::Zipper(inputs)) {
+    for (auto &&[input] : containers::Zipper(view, inputs)) {
         const auto &it = input.actions.find(pressed_key);
 
         if (it != input.actions.end()) {
@@ -13,6 +13,7 @@ static void trigger_action(SparseArray<Component::Input> &inputs, keyboardInput
 }
 
 void System::input_system(Registry &r,
+                          View const &view,
                           SparseArray<Component::Input> &inputs)
 {
     sf::Event event;
@@ -26,7 +27,7 @@ void System::input_system(Registry &r,
         if (event.type == sf::Event::KeyPressed) {
             keyboardInput pressed_key = get_keyboard_input_from_sfml(event.key.code);
 
-            trigger_action(inputs, pressed_key);
+            trigger_action(view, inputs, pressed_key);
         }
     }
 }
@@ -0,0 +1,19 @@
+#include "Registry.hpp"
+#include "Systems.hpp"
+
+void System::interpolation_system(Registry &r,
+                                  View const &view,
+                                  SparseArray<Component::Transform> &transforms,
+                                  SparseArray<Component::PreviousTransform> &previous,
+                                  SparseArray<Component::Interpolated> &interpolated)
+{
+    // the remote entities are drawn a delay behind the server, between the states around it,
+    // so the draw_system doesn't blend them with the previous tick
+    double render_time = r.get_interpolation_clock().get_render_time();
+
+    for (auto &&[tf, prev, states] : containers::Zipper(view, transforms, previous, interpolated))
+    {
+        states.sample(render_time, tf);
+        prev.transform = tf;
+    }
+}
@@ -2,11 +2,12 @@
 #include "Systems.hpp"
 
 void System::kill_system(Registry &r,
+                         View const &view,
                          SparseArray<Component::Mortal> &mortals)
 {
-  for (auto &&[mtl] : containers::Zipper(mortals))
+  for (auto &&[idx, mtl] : containers::IndexedZipper(view, mortals))
   {
     if (mtl.health_points == 0)
-      r.kill_entity(r.entity_from_index(mtl.entity_id));
+      r.kill_entity(r.entity_from_index(idx));
   }
 }
\ No newline at end of file
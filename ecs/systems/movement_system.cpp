@@ -2,14 +2,15 @@
 #include "Systems.hpp"
 
 void System::movement_system(Registry &r,
+                             View const &view,
                              SparseArray<Component::Transform> &transforms,
                              SparseArray<Component::RigidBody> &rigid_bodies)
 {
-    for (auto &&[tfm, rb] : containers::Zipper(transforms, rigid_bodies))
-    {
-        sf::Time delta_time = rb.delta_clock_movement.restart();
+    float delta_time = r.get_timestep().get_delta_time();
 
-        rb.velocity += rb.acceleration * delta_time.asSeconds();
-        tfm.position += rb.velocity * delta_time.asSeconds();
-    }
+    containers::Zipper(view, transforms, rigid_bodies).parallel_each(r.get_thread_pool(), [delta_time](Component::Transform &tfm, Component::RigidBody &rb)
+    {
+        rb.velocity += rb.acceleration * delta_time;
+        tfm.position += rb.velocity * delta_time;
+    });
 }
@@ -3,13 +3,15 @@
 #include <cmath>
 
 void System::physics_system(Registry &r,
+                            View const &view,
                             SparseArray<Component::RigidBody> &rigid_bodies)
 {
-  for (auto &&[rb] : containers::Zipper(rigid_bodies))
-  {
-    sf::Time delta_time = rb.delta_clock_physics.restart();
+  // every entity is damped by the same tick, so the factor is computed once
+  float damping = powf(0.1, r.get_timestep().get_delta_time());
 
-    rb.acceleration *= powf(0.1, delta_time.asSeconds());
-    rb.velocity *= powf(0.1, delta_time.asSeconds());
-  }
+  containers::Zipper(view, rigid_bodies).parallel_each(r.get_thread_pool(), [damping](Component::RigidBody &rb)
+  {
+    rb.acceleration *= damping;
+    rb.velocity *= damping;
+  });
 }
@@ -0,0 +1,14 @@
+#include "Registry.hpp"
+#include "Systems.hpp"
+
+void System::previous_transform_system(Registry &r,
+                                       View const &view,
+                                       SparseArray<Component::Transform> &transforms,
+                                       SparseArray<Component::PreviousTransform> &previous)
+{
+    // run before the systems moving the entities, to keep where they start the tick from
+    containers::Zipper(view, transforms, previous).parallel_each(r.get_thread_pool(), [](Component::Transform &tf, Component::PreviousTransform &prev)
+    {
+        prev.transform = tf;
+    });
+}
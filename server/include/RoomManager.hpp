@@ -0,0 +1,240 @@
+#ifndef ROOM_MANAGER_HPP
+#define ROOM_MANAGER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Registry.hpp"
+
+typedef std::size_t RoomID;
+
+/**
+ * @brief The tick time statistics of a room.
+ *
+ */
+struct RoomStats
+{
+    RoomID room;
+    /**
+     * @brief The index of the worker thread running
+     * the room.
+     *
+     */
+    std::size_t worker;
+    /**
+     * @brief The number of ticks run so far.
+     *
+     */
+    std::uint64_t ticks;
+    /**
+     * @brief The time taken by the last tick, in
+     * milliseconds.
+     *
+     */
+    float last_tick_ms;
+    /**
+     * @brief The moving average of the tick time, in
+     * milliseconds.
+     *
+     */
+    float average_tick_ms;
+    /**
+     * @brief The longest tick time, in milliseconds.
+     *
+     */
+    float max_tick_ms;
+};
+
+/**
+ * @brief The functions called by the worker of a room around
+ * each of its ticks, e.g. to apply the inputs received for the
+ * tick and to send the resulting state to the players. Either
+ * one can be empty.
+ *
+ */
+struct RoomHooks
+{
+    std::function<void(Registry &)> before_tick;
+    std::function<void(Registry &)> after_tick;
+};
+
+/**
+ * @brief Hosts many independent games (rooms), each one in
+ * its own headless Registry. The rooms are spread over a
+ * fixed set of worker threads, the least loaded one taking
+ * each new room, and a room always runs on the same worker
+ * so its registry is never touched by two threads. Each
+ * worker runs the due ticks of its rooms, then sleeps until
+ * the next one is due.
+ *
+ * e.g:
+ * ```cpp
+ * RoomManager rooms(4);
+ * RoomID id = rooms.create_room();
+ *
+ * ...
+ *
+ * for (RoomStats const &stats : rooms.get_stats())
+ *     std::cout << stats.room << ": " << stats.average_tick_ms << "ms\n";
+ * rooms.close_room(id);
+ * ```
+ *
+ */
+class RoomManager
+{
+public:
+    using setup_type = std::function<void(Registry &)>;
+
+    /**
+     * @brief The weight of the last tick in the moving
+     * average of RoomStats::average_tick_ms.
+     *
+     */
+    static constexpr float AVERAGE_WEIGHT = 0.05f;
+    /**
+     * @brief The longest time a worker sleeps, e.g. when
+     * it has no room.
+     *
+     */
+    static constexpr std::chrono::milliseconds MAX_SLEEP = std::chrono::milliseconds(100);
+
+    /**
+     * @brief Start the worker threads.
+     *
+     * @param workers The number of worker threads, 0 starts
+     * one per hardware thread.
+     */
+    explicit RoomManager(std::size_t workers = 0);
+    ~RoomManager();
+
+    RoomManager(RoomManager const &) = delete;
+    RoomManager &operator=(RoomManager const &) = delete;
+
+    /**
+     * @brief Create a room and give it to the least loaded
+     * worker. The registry is set up on the calling thread,
+     * before any tick.
+     *
+     * @param setup The function setting up the registry of
+     * the room, Registry::setup() by default.
+     * @param hooks The functions called around each tick of
+     * the room, on its worker.
+     * @return RoomID The id of the new room.
+     */
+    RoomID create_room(setup_type const &setup = [](Registry &r) { r.setup(); }, RoomHooks const &hooks = RoomHooks());
+    /**
+     * @brief Close a room. Its registry is destroyed by its
+     * worker, after its current tick. Nothing is done if
+     * there is no such room.
+     *
+     * @param id The id of the room.
+     */
+    void close_room(RoomID id);
+
+    /**
+     * @brief Get the number of rooms running.
+     *
+     */
+    std::size_t get_room_count() const;
+    /**
+     * @brief Get the number of worker threads.
+     *
+     */
+    std::size_t get_worker_count() const;
+    /**
+     * @brief Get the tick time statistics of every room, as
+     * of the last loop of their worker.
+     *
+     */
+    std::vector<RoomStats> get_stats() const;
+
+private:
+    /**
+     * @brief A game and its statistics, only used by
+     * the worker running it.
+     *
+     */
+    struct Room
+    {
+        std::unique_ptr<Registry> registry;
+        RoomHooks hooks;
+        std::chrono::steady_clock::time_point last_update;
+        RoomStats stats;
+    };
+
+    /**
+     * @brief A worker thread and the rooms it runs.
+     *
+     */
+    struct Worker
+    {
+        std::thread thread;
+        /**
+         * @brief The rooms run by the worker, only used
+         * by the worker thread.
+         *
+         */
+        std::vector<std::unique_ptr<Room>> rooms;
+        /**
+         * @brief The rooms created and not taken by the
+         * worker yet.
+         *
+         */
+        std::vector<std::unique_ptr<Room>> incoming;
+        /**
+         * @brief The ids of the rooms to be closed.
+         *
+         */
+        std::vector<RoomID> closing;
+        /**
+         * @brief The statistics of the rooms, copied at
+         * each loop of the worker.
+         *
+         */
+        std::vector<RoomStats> stats;
+        std::mutex mutex;
+        /**
+         * @brief Notified when rooms are given or closed,
+         * or the manager stops.
+         *
+         */
+        std::condition_variable wake;
+    };
+
+    void work(std::size_t index);
+    void take_rooms(Worker &worker);
+    void run_rooms(Worker &worker, std::chrono::steady_clock::time_point &next_tick);
+    static std::size_t update(Room &room, float seconds);
+
+    /**
+     * @brief The worker threads.
+     *
+     */
+    std::vector<std::unique_ptr<Worker>> _workers;
+    /**
+     * @brief The worker of each room.
+     *
+     */
+    std::map<RoomID, std::size_t> _rooms;
+    /**
+     * @brief The number of rooms of each worker.
+     *
+     */
+    std::vector<std::size_t> _loads;
+    RoomID _next_room;
+    /**
+     * @brief Indicate if the workers must stop.
+     *
+     */
+    std::atomic<bool> _stop;
+    mutable std::mutex _mutex;
+};
+
+#endif /* ROOM_MANAGER_HPP */
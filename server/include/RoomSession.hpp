@@ -0,0 +1,159 @@
+#ifndef ROOM_SESSION_HPP
+#define ROOM_SESSION_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "net_server.h"
+#include "net_replication.h"
+#include "RoomManager.hpp"
+
+/**
+ * @brief The players of a room and their connections. The
+ * datagrams of the players are pushed by the network thread and
+ * handled by the worker of the room before each tick, a player
+ * joining on its first datagram (a JoinMessage, sent by the
+ * client until its player is spawned). The inputs of each player are
+ * queued and one of them is applied per tick, as the client
+ * predicting the player does. At the snapshot rate, after a
+ * tick, the state of the room is captured and sent to every
+ * player, delta-encoded against the last snapshot it
+ * acknowledged.
+ *
+ * e.g:
+ * ```cpp
+ * auto session = std::make_shared<RoomSession>(server, 30);
+ *
+ * rooms.create_room([](Registry &r) { r.setup(false); }, session->get_hooks());
+ * server.poll([&session](net::Packet const &packet) { session->push(packet); });
+ * ```
+ *
+ */
+class RoomSession : public std::enable_shared_from_this<RoomSession>
+{
+public:
+    /**
+     * @brief The number of players of a room.
+     *
+     */
+    static constexpr std::size_t MAX_PLAYERS = 4;
+    /**
+     * @brief The time after which a silent player leaves.
+     *
+     */
+    static constexpr std::chrono::seconds PLAYER_TIMEOUT = std::chrono::seconds(5);
+    /**
+     * @brief The number of inputs queued per player, the oldest
+     * one being dropped past it so a client running ahead doesn't
+     * add latency.
+     *
+     */
+    static constexpr std::size_t MAX_QUEUED_INPUTS = 8;
+
+    /**
+     * @brief Construct a new RoomSession object.
+     *
+     * @param server The socket of the players.
+     * @param snapshot_rate The number of snapshots sent per
+     * second. A snapshot is sent every so many ticks, and at
+     * most once per tick.
+     */
+    RoomSession(net::UdpServer &server, unsigned snapshot_rate);
+    ~RoomSession();
+
+    RoomSession(RoomSession const &) = delete;
+    RoomSession &operator=(RoomSession const &) = delete;
+
+    /**
+     * @brief Get the hooks to create the room with. They keep
+     * the session alive as long as the room.
+     *
+     */
+    RoomHooks get_hooks();
+
+    /**
+     * @brief Queue a datagram of a player, the datagram of an
+     * unknown endpoint making it join the room. It can be called
+     * from any thread.
+     *
+     */
+    void push(net::Packet const &packet);
+    /**
+     * @brief Take the endpoints of the players that left the
+     * room since the last call, e.g. to stop routing their
+     * datagrams to it. It can be called from any thread.
+     *
+     */
+    std::vector<udp::endpoint> take_left();
+
+private:
+    /**
+     * @brief A player and its connection, only used by the
+     * worker of the room.
+     *
+     */
+    struct Player
+    {
+        Entity entity;
+        net::Connection connection;
+        /**
+         * @brief The last snapshot acknowledged, the baseline
+         * of the next ones.
+         *
+         */
+        std::optional<std::uint32_t> acked_tick;
+        std::chrono::steady_clock::time_point last_received;
+        /**
+         * @brief The inputs received and not applied yet.
+         *
+         */
+        std::deque<net::InputMessage> inputs;
+        /**
+         * @brief The tick of the last input applied, sent with
+         * the snapshots for the client to reconcile.
+         *
+         */
+        std::uint32_t input_tick;
+    };
+
+    void receive(Registry &r);
+    void replicate(Registry &r);
+    Player &join(Registry &r, udp::endpoint const &endpoint);
+    void handle(Player &player, net::Packet const &packet);
+    void leave_silent(Registry &r);
+    void apply_inputs(Registry &r);
+
+    net::UdpServer &_server;
+    /**
+     * @brief The players, by endpoint.
+     *
+     */
+    std::map<udp::endpoint, Player> _players;
+    unsigned _snapshot_rate;
+    /**
+     * @brief The snapshots sent, the baselines of the next ones.
+     * The next snapshot is captured in it.
+     *
+     */
+    net::SnapshotHistory _history;
+    /**
+     * @brief The datagrams pushed and not handled yet.
+     *
+     */
+    std::vector<net::Packet> _inbox;
+    /**
+     * @brief The datagrams being handled, swapped with the
+     * inbox to reuse their memory.
+     *
+     */
+    std::vector<net::Packet> _received;
+    std::vector<udp::endpoint> _left;
+    std::mutex _mutex;
+};
+
+#endif /* ROOM_SESSION_HPP */
@@ -3,5 +3,38 @@
 
 #include <iostream>
 #include "Registry.hpp"
+#include "RoomManager.hpp"
+#include "RoomSession.hpp"
+
+/**
+ * @brief The period of the rooms statistics report,
+ * in seconds.
+ *
+ */
+#define STATS_PERIOD 10
+/**
+ * @brief The port the server listens on.
+ *
+ */
+#define SERVER_PORT 12345
+/**
+ * @brief The period the received datagrams are routed to
+ * their room at, in milliseconds.
+ *
+ */
+#define POLL_PERIOD 1
+/**
+ * @brief The number of snapshots sent to the players per
+ * second, half the tick rate.
+ *
+ */
+#define SNAPSHOT_RATE 30
+/**
+ * @brief The maximum number of rooms the server runs, the
+ * ones opened at start and the ones opened as players join.
+ * Past it, the players of a new endpoint are turned away.
+ *
+ */
+#define MAX_ROOMS 64
 
 #endif /* MAIN_HPP */
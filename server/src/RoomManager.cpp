@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <iostream>
+#ifdef __linux__
+#include <pthread.h>
+#endif
+#include "RoomManager.hpp"
+
+using clock_type = std::chrono::steady_clock;
+
+RoomManager::RoomManager(std::size_t workers)
+    : _workers(),
+      _rooms(),
+      _loads(),
+      _next_room(0),
+      _stop(false)
+{
+    if (workers == 0)
+        workers = std::max(std::thread::hardware_concurrency(), 1u);
+    _loads.resize(workers, 0);
+    for (std::size_t i = 0; i < workers; i++)
+        _workers.push_back(std::make_unique<Worker>());
+    for (std::size_t i = 0; i < workers; i++)
+        _workers[i]->thread = std::thread(&RoomManager::work, this, i);
+}
+
+RoomManager::~RoomManager()
+{
+    _stop = true;
+    for (auto &worker : _workers)
+    {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+        }
+        worker->wake.notify_one();
+    }
+    for (auto &worker : _workers)
+        worker->thread.join();
+}
+
+RoomID RoomManager::create_room(setup_type const &setup, RoomHooks const &hooks)
+{
+    auto room = std::make_unique<Room>();
+
+    room->registry = std::make_unique<Registry>(true);
+    setup(*room->registry);
+    room->hooks = hooks;
+    room->last_update = clock_type::now();
+    room->stats = RoomStats{0, 0, 0, 0.0f, 0.0f, 0.0f};
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::size_t index = std::min_element(_loads.begin(), _loads.end()) - _loads.begin();
+    Worker &worker = *_workers[index];
+
+    room->stats.room = _next_room;
+    room->stats.worker = index;
+    _rooms[_next_room] = index;
+    ++_loads[index];
+    {
+        std::lock_guard<std::mutex> worker_lock(worker.mutex);
+
+        worker.incoming.push_back(std::move(room));
+    }
+    worker.wake.notify_one();
+    return _next_room++;
+}
+
+void RoomManager::close_room(RoomID id)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _rooms.find(id);
+
+    if (it == _rooms.end())
+        return;
+    Worker &worker = *_workers[it->second];
+
+    --_loads[it->second];
+    _rooms.erase(it);
+    {
+        std::lock_guard<std::mutex> worker_lock(worker.mutex);
+
+        worker.closing.push_back(id);
+    }
+    worker.wake.notify_one();
+}
+
+std::size_t RoomManager::get_room_count() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _rooms.size();
+}
+
+std::size_t RoomManager::get_worker_count() const
+{
+    return _workers.size();
+}
+
+std::vector<RoomStats> RoomManager::get_stats() const
+{
+    std::vector<RoomStats> stats;
+
+    for (auto const &worker : _workers)
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+
+        stats.insert(stats.end(), worker->stats.begin(), worker->stats.end());
+    }
+    return stats;
+}
+
+void RoomManager::work(std::size_t index)
+{
+    Worker &worker = *_workers[index];
+
+#ifdef __linux__
+    // keep the worker, and so its rooms, on the same core
+    unsigned int cores = std::thread::hardware_concurrency();
+
+    if (cores > 0)
+    {
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        CPU_SET(index % cores, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+    while (!_stop)
+    {
+        clock_type::time_point next_tick = clock_type::now() + MAX_SLEEP;
+
+        take_rooms(worker);
+        run_rooms(worker, next_tick);
+
+        std::unique_lock<std::mutex> lock(worker.mutex);
+
+        worker.stats.clear();
+        for (auto const &room : worker.rooms)
+            worker.stats.push_back(room->stats);
+        worker.wake.wait_until(lock, next_tick, [this, &worker]()
+                               { return _stop || !worker.incoming.empty() || !worker.closing.empty(); });
+    }
+}
+
+void RoomManager::take_rooms(Worker &worker)
+{
+    std::vector<std::unique_ptr<Room>> closed;
+
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+
+        for (auto &room : worker.incoming)
+            worker.rooms.push_back(std::move(room));
+        worker.incoming.clear();
+        for (RoomID id : worker.closing)
+        {
+            auto it = std::find_if(worker.rooms.begin(), worker.rooms.end(), [id](auto const &room)
+                                   { return room->stats.room == id; });
+
+            if (it != worker.rooms.end())
+            {
+                closed.push_back(std::move(*it));
+                worker.rooms.erase(it);
+            }
+        }
+        worker.closing.clear();
+    }
+    // the registries are destroyed once the lock is released
+}
+
+void RoomManager::run_rooms(Worker &worker, clock_type::time_point &next_tick)
+{
+    for (std::size_t i = 0; i < worker.rooms.size(); i++)
+    {
+        Room &room = *worker.rooms[i];
+        clock_type::time_point begin = clock_type::now();
+        std::size_t ticks = 0;
+
+        try
+        {
+            ticks = update(room, std::chrono::duration<float>(begin - room.last_update).count());
+        }
+        catch (std::exception const &e)
+        {
+            // a broken room must not stop the other rooms of the worker
+            std::cerr << "room " << room.stats.room << " closed: " << e.what() << std::endl;
+            close_room(room.stats.room);
+            continue;
+        }
+        clock_type::time_point end = clock_type::now();
+        Timestep const &timestep = room.registry->get_timestep();
+
+        room.last_update = begin;
+        if (ticks > 0)
+        {
+            float tick_ms = std::chrono::duration<float, std::milli>(end - begin).count() / ticks;
+
+            room.stats.average_tick_ms = (room.stats.ticks == 0 ? tick_ms : room.stats.average_tick_ms + AVERAGE_WEIGHT * (tick_ms - room.stats.average_tick_ms));
+            room.stats.ticks += ticks;
+            room.stats.last_tick_ms = tick_ms;
+            room.stats.max_tick_ms = std::max(room.stats.max_tick_ms, tick_ms);
+        }
+        next_tick = std::min(next_tick, begin + std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<float>((1.0f - timestep.get_alpha()) * timestep.get_delta_time())));
+    }
+}
+
+std::size_t RoomManager::update(Room &room, float seconds)
+{
+    Registry &registry = *room.registry;
+    Timestep &timestep = registry.get_timestep();
+    std::size_t ticks = 0;
+
+    timestep.accumulate(seconds);
+    while (timestep.consume_tick())
+    {
+        if (room.hooks.before_tick)
+            room.hooks.before_tick(registry);
+        registry.run_systems();
+        if (room.hooks.after_tick)
+            room.hooks.after_tick(registry);
+        ++ticks;
+    }
+    return ticks;
+}
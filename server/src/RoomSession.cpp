@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cmath>
+#include "RoomSession.hpp"
+#include "net_prediction.h"
+
+using clock_type = std::chrono::steady_clock;
+
+RoomSession::RoomSession(net::UdpServer &server, unsigned snapshot_rate)
+    : _server(server),
+      _players(),
+      _snapshot_rate(snapshot_rate),
+      _history(),
+      _inbox(),
+      _received(),
+      _left()
+{
+}
+
+RoomSession::~RoomSession()
+{
+}
+
+RoomHooks RoomSession::get_hooks()
+{
+    std::shared_ptr<RoomSession> self = shared_from_this();
+
+    return RoomHooks{[self](Registry &r) { self->receive(r); }, [self](Registry &r) { self->replicate(r); }};
+}
+
+void RoomSession::push(net::Packet const &packet)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _inbox.push_back(packet);
+}
+
+std::vector<udp::endpoint> RoomSession::take_left()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<udp::endpoint> left;
+
+    left.swap(_left);
+    return left;
+}
+
+void RoomSession::receive(Registry &r)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _received.swap(_inbox);
+    }
+    for (net::Packet const &packet : _received)
+    {
+        auto it = _players.find(packet.endpoint);
+
+        handle((it == _players.end()) ? join(r, packet.endpoint) : it->second, packet);
+    }
+    _received.clear();
+    leave_silent(r);
+    apply_inputs(r);
+}
+
+RoomSession::Player &RoomSession::join(Registry &r, udp::endpoint const &endpoint)
+{
+    Vec2 position(100.0f, 150.0f + 100.0f * static_cast<float>(_players.size()));
+    Prefab::Player prefab(r, Component::Transform{.position = position, .rotation = 0.0f, .scale = Vec2(3.0f, 3.0f)}, Component::RigidBody{.mass = 1.0f, .velocity = Vec2(0.0f, 0.0f), .acceleration = Vec2(0.0f, 0.0f)});
+    Player &player = _players.emplace(endpoint, Player{prefab.entity, net::Connection(), std::nullopt, clock_type::now(), {}, net::K_NO_INPUT}).first->second;
+
+    // the client learns which entity it controls
+    player.connection.send_reliable(net::MESSAGE_SPAWN, net::SpawnMessage{prefab.entity.get_handle(), net::PREFAB_LOCAL_PLAYER, position.x, position.y});
+    std::cout << "player " << endpoint << " joined" << std::endl;
+    return player;
+}
+
+void RoomSession::handle(Player &player, net::Packet const &packet)
+{
+    // the clients don't send reliable messages
+    net::receiveStatus status = player.connection.receive(packet, [](net::MessageReader &) {});
+    net::MessageReader reader(packet);
+
+    if (status == net::RECEIVE_DROPPED)
+        return;
+    player.last_received = clock_type::now();
+    if (status != net::RECEIVE_NEW)
+        return;
+    if (reader.header().type == net::MESSAGE_SNAPSHOT_ACK)
+    {
+        net::SnapshotAckMessage ack;
+
+        if (ack.read(reader) && (!player.acked_tick || static_cast<std::int32_t>(ack.tick - *player.acked_tick) > 0))
+            player.acked_tick = ack.tick;
+    }
+    else if (reader.header().type == net::MESSAGE_INPUT)
+    {
+        net::InputMessage input;
+
+        if (!input.read(reader))
+            return;
+        if (player.inputs.size() == MAX_QUEUED_INPUTS)
+            player.inputs.pop_front();
+        player.inputs.push_back(input);
+    }
+}
+
+void RoomSession::apply_inputs(Registry &r)
+{
+    for (auto &[endpoint, player] : _players)
+    {
+        if (player.inputs.empty())
+            continue;
+        net::apply_input(r, player.entity, player.inputs.front());
+        player.input_tick = player.inputs.front().tick;
+        player.inputs.pop_front();
+    }
+}
+
+void RoomSession::leave_silent(Registry &r)
+{
+    clock_type::time_point now = clock_type::now();
+
+    for (auto it = _players.begin(); it != _players.end();)
+    {
+        if (now - it->second.last_received < PLAYER_TIMEOUT)
+        {
+            ++it;
+            continue;
+        }
+        std::cout << "player " << it->first << " left" << std::endl;
+        if (r.is_alive(it->second.entity))
+            r.kill_entity(it->second.entity);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            _left.push_back(it->first);
+        }
+        it = _players.erase(it);
+    }
+}
+
+void RoomSession::replicate(Registry &r)
+{
+    Timestep const &timestep = r.get_timestep();
+    float ticks_per_snapshot = 1.0f / (timestep.get_delta_time() * static_cast<float>(_snapshot_rate));
+    std::uint64_t interval = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::lround(ticks_per_snapshot)));
+
+    if (_players.empty() || (timestep.get_tick() % interval != 0))
+        return;
+    net::Snapshot &snapshot = _history.next();
+
+    net::capture_snapshot(r, static_cast<std::uint32_t>(timestep.get_tick()), snapshot);
+    for (auto &[endpoint, player] : _players)
+    {
+        net::Connection &connection = player.connection;
+        net::Snapshot const *baseline = player.acked_tick ? _history.find(*player.acked_tick) : nullptr;
+        auto acquire = [this]() { return _server.acquire_packet(); };
+        auto send = [this, &endpoint = endpoint](net::Packet *packet) { _server.send_packet(packet, endpoint); };
+
+        net::encode_snapshot(snapshot, baseline, player.input_tick, connection.make_header(net::MESSAGE_SNAPSHOT), acquire, [&connection, &send](net::Packet *packet)
+        {
+            connection.stamp(*packet);
+            send(packet);
+        });
+        connection.flush(acquire, send);
+    }
+    // the snapshot is captured out of the history, so the baselines stay valid until here
+    _history.push();
+}
@@ -1,12 +1,149 @@
 #include "net_server.h"
 #include "main.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
 using namespace boost::asio;
 
-int main()
+/**
+ * @brief Set by SIGINT and SIGTERM to end the routing loop,
+ * so the rooms and the socket are closed on exit.
+ *
+ */
+static volatile std::sig_atomic_t stop_requested = 0;
+
+static void request_stop(int)
+{
+    stop_requested = 1;
+}
+
+/**
+ * @brief Parse a strictly positive count.
+ *
+ * @return std::size_t The count, 0 if the argument isn't one.
+ */
+static std::size_t parse_count(char const *arg)
+{
+    char *end = nullptr;
+    unsigned long count = 0;
+
+    if ((arg[0] < '0') || (arg[0] > '9'))
+        return 0;
+    errno = 0;
+    count = std::strtoul(arg, &end, 10);
+    if ((errno != 0) || (*end != '\0'))
+        return 0;
+    return count;
+}
+
+/**
+ * @brief A room and the number of players routed to it.
+ *
+ */
+struct RoutedRoom
 {
-    Registry r;
+    std::shared_ptr<RoomSession> session;
+    std::size_t players;
+};
+
+static void open_room(RoomManager &rooms, std::vector<RoutedRoom> &routed, net::UdpServer &server)
+{
+    auto session = std::make_shared<RoomSession>(server, SNAPSHOT_RATE);
+
+    // the players are spawned as the clients join
+    rooms.create_room([](Registry &r) { r.setup(false); }, session->get_hooks());
+    routed.push_back(RoutedRoom{session, 0});
+}
+
+/**
+ * @brief Get the room a new player joins, the least populated
+ * one. A room is opened when every room is full.
+ *
+ * @return std::size_t The index of the room, routed.size()
+ * if every room is full and MAX_ROOMS are open.
+ */
+static std::size_t pick_room(RoomManager &rooms, std::vector<RoutedRoom> &routed, net::UdpServer &server)
+{
+    auto it = std::min_element(routed.begin(), routed.end(), [](RoutedRoom const &lhs, RoutedRoom const &rhs)
+                               { return lhs.players < rhs.players; });
+
+    if ((it != routed.end()) && (it->players < RoomSession::MAX_PLAYERS))
+        return it - routed.begin();
+    if (routed.size() >= MAX_ROOMS)
+        return routed.size();
+    open_room(rooms, routed, server);
+    return routed.size() - 1;
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t room_count = (argc > 1) ? parse_count(argv[1]) : 1;
+
+    if ((argc > 2) || (room_count == 0) || (room_count > MAX_ROOMS))
+    {
+        std::cerr << "Usage: " << argv[0] << " [room_count]" << std::endl
+                  << "  room_count: the number of rooms to open at start, from 1 to " << MAX_ROOMS << " (default 1)" << std::endl;
+        return 1;
+    }
+
+    io_context io_context;
+    net::UdpServer server(io_context, udp::endpoint(udp::v4(), SERVER_PORT));
+    RoomManager rooms;
+    std::vector<RoutedRoom> routed;
+    std::map<udp::endpoint, std::size_t> routes;
+    std::thread io_thread([&io_context]() { io_context.run(); });
+    net::IoThreadGuard<net::UdpServer> io_thread_guard{server, io_thread};
+    auto next_stats = std::chrono::steady_clock::now() + std::chrono::seconds(STATS_PERIOD);
+
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+    for (std::size_t i = 0; i < room_count; i++)
+        open_room(rooms, routed, server);
+    while (!stop_requested)
+    {
+        server.poll([&](net::Packet const &packet)
+        {
+            if (!net::MessageReader(packet).ok())
+                return;
+            auto it = routes.find(packet.endpoint);
+
+            if (it == routes.end())
+            {
+                std::size_t room = pick_room(rooms, routed, server);
 
-    r.run();
+                if (room == routed.size())
+                    return;
+                it = routes.emplace(packet.endpoint, room).first;
+                ++routed[it->second].players;
+            }
+            routed[it->second].session->push(packet);
+        });
+        for (RoutedRoom &room : routed)
+        {
+            for (udp::endpoint const &endpoint : room.session->take_left())
+            {
+                if (routes.erase(endpoint) > 0)
+                    --room.players;
+            }
+        }
+        if (std::chrono::steady_clock::now() >= next_stats)
+        {
+            next_stats += std::chrono::seconds(STATS_PERIOD);
+            for (RoomStats const &stats : rooms.get_stats())
+            {
+                std::cout << "room " << stats.room << " (worker " << stats.worker << "): "
+                          << stats.ticks << " ticks, " << stats.average_tick_ms << "ms avg, "
+                          << stats.max_tick_ms << "ms max" << std::endl;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_PERIOD));
+    }
     return 0;
 }
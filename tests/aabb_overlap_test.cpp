@@ -0,0 +1,170 @@
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "aabb_overlap.hpp"
+#include "sfml_bouding_box.hpp"
+
+/**
+ * @brief The exit code of a test that can't run on the machine,
+ * reported as skipped by ctest (see SKIP_RETURN_CODE).
+ *
+ */
+#define TEST_SKIPPED 77
+
+/**
+ * @brief A batch of boxes, one array per coordinate.
+ *
+ */
+struct Boxes
+{
+    std::vector<float> min_x;
+    std::vector<float> min_y;
+    std::vector<float> max_x;
+    std::vector<float> max_y;
+
+    void add(float left, float top, float width, float height)
+    {
+        min_x.push_back(left);
+        min_y.push_back(top);
+        max_x.push_back(left + width);
+        max_y.push_back(top + height);
+    }
+
+    std::size_t size() const
+    {
+        return min_x.size();
+    }
+
+    Rect rect(std::size_t i) const
+    {
+        return Rect(min_x[i], min_y[i], max_x[i] - min_x[i], max_y[i] - min_y[i]);
+    }
+};
+
+static int FAILURES = 0;
+
+/**
+ * @brief Compare overlap_batch() with isCollision() and with a
+ * scalar loop, for a box against the count first boxes.
+ *
+ */
+static void check(const Boxes &boxes, std::size_t box, std::size_t count)
+{
+    AabbBatch batch{boxes.min_x.data(), boxes.min_y.data(), boxes.max_x.data(), boxes.max_y.data()};
+    std::vector<std::uint32_t> hits(count + 1, 0);
+    std::vector<std::uint32_t> expected;
+    std::size_t found = overlap_batch(boxes.min_x[box], boxes.min_y[box], boxes.max_x[box], boxes.max_y[box], batch, count, hits.data());
+
+    for (std::uint32_t i = 0; i < count; i++) {
+        bool scalar = (boxes.min_x[box] <= boxes.max_x[i]) && (boxes.min_x[i] <= boxes.max_x[box]) &&
+                      (boxes.min_y[box] <= boxes.max_y[i]) && (boxes.min_y[i] <= boxes.max_y[box]);
+
+        if (scalar != isCollision(boxes.rect(box), boxes.rect(i))) {
+            std::cerr << "scalar and isCollision disagree on boxes " << box << " and " << i << std::endl;
+            FAILURES++;
+        }
+        if (scalar)
+            expected.push_back(i);
+    }
+    hits.resize(found);
+    if (hits != expected) {
+        std::cerr << "box " << box << " against " << count << " boxes: " << found << " hits, "
+                  << expected.size() << " expected" << std::endl;
+        FAILURES++;
+    }
+}
+
+/**
+ * @brief Every box of the batch against every prefix of it, so
+ * the counts that aren't a multiple of the width go through the
+ * scalar tail.
+ *
+ */
+static void check_all(const Boxes &boxes)
+{
+    for (std::size_t box = 0; box < boxes.size(); box++) {
+        for (std::size_t count = 0; count <= boxes.size(); count++)
+            check(boxes, box, count);
+    }
+}
+
+static void test_touching_edges()
+{
+    Boxes boxes;
+
+    boxes.add(0.0f, 0.0f, 10.0f, 10.0f);
+    // sharing the right, bottom and left edges and a corner
+    boxes.add(10.0f, 0.0f, 10.0f, 10.0f);
+    boxes.add(0.0f, 10.0f, 10.0f, 10.0f);
+    boxes.add(-10.0f, 0.0f, 10.0f, 10.0f);
+    boxes.add(10.0f, 10.0f, 5.0f, 5.0f);
+    // just apart
+    boxes.add(10.5f, 0.0f, 10.0f, 10.0f);
+    boxes.add(0.0f, -10.5f, 10.0f, 10.0f);
+    boxes.add(-5.0f, -5.0f, 4.5f, 4.5f);
+    boxes.add(20.0f, 20.0f, 1.0f, 1.0f);
+    check_all(boxes);
+}
+
+static void test_zero_size()
+{
+    Boxes boxes;
+
+    boxes.add(0.0f, 0.0f, 10.0f, 10.0f);
+    // points inside, on the edges, on a corner and outside
+    boxes.add(5.0f, 5.0f, 0.0f, 0.0f);
+    boxes.add(10.0f, 5.0f, 0.0f, 0.0f);
+    boxes.add(0.0f, 0.0f, 0.0f, 0.0f);
+    boxes.add(10.0f, 10.0f, 0.0f, 0.0f);
+    boxes.add(11.0f, 5.0f, 0.0f, 0.0f);
+    // flat boxes, crossing and along the edges
+    boxes.add(-5.0f, 5.0f, 20.0f, 0.0f);
+    boxes.add(5.0f, -5.0f, 0.0f, 20.0f);
+    boxes.add(0.0f, 10.0f, 10.0f, 0.0f);
+    boxes.add(5.0f, 5.0f, 0.0f, 0.0f);
+    check_all(boxes);
+}
+
+/**
+ * @brief Boxes snapped to a small grid, so most of them touch or
+ * overlap, in batches of every count up to a few widths.
+ *
+ */
+static void test_random()
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> position(0, 16);
+    std::uniform_int_distribution<int> size(0, 4);
+
+    for (int round = 0; round < 20; round++) {
+        Boxes boxes;
+
+        for (std::size_t i = 0; i < 37; i++)
+            boxes.add(position(rng), position(rng), size(rng), size(rng));
+        check_all(boxes);
+    }
+}
+
+int main()
+{
+#if AABB_OVERLAP_WIDTH == 8 && (defined(__GNUC__) || defined(__clang__))
+    if (!__builtin_cpu_supports("avx")) {
+        std::cout << "AVX isn't supported, skipped" << std::endl;
+        return TEST_SKIPPED;
+    }
+#endif
+#ifdef EXPECTED_WIDTH
+    if (AABB_OVERLAP_WIDTH != EXPECTED_WIDTH) {
+        std::cerr << "overlap_batch tests " << AABB_OVERLAP_WIDTH << " boxes at once, "
+                  << EXPECTED_WIDTH << " expected" << std::endl;
+        return EXIT_FAILURE;
+    }
+#endif
+    test_touching_edges();
+    test_zero_size();
+    test_random();
+    std::cout << "overlap_batch (width " << AABB_OVERLAP_WIDTH << "): "
+              << ((FAILURES == 0) ? "passed" : "FAILED") << std::endl;
+    return (FAILURES == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,73 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include "RoomSession.hpp"
+#include "ClientSession.hpp"
+
+/**
+ * @brief The ticks a fresh client has to get its player.
+ *
+ */
+#define TEST_TICKS 300
+
+static int FAILURES = 0;
+
+/**
+ * @brief Run a room session and a fresh client over loopback
+ * sockets, nothing wired by hand: the client must make itself
+ * known, be spawned a player and predict it once replicated.
+ *
+ */
+static void test_join()
+{
+    boost::asio::io_context server_context;
+    boost::asio::io_context client_context;
+    net::UdpServer server(server_context, udp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    net::UdpClient client(client_context, server.local_endpoint());
+    std::thread server_thread([&server_context]() { server_context.run(); });
+    net::IoThreadGuard<net::UdpServer> server_guard{server, server_thread};
+    std::thread client_thread([&client_context]() { client_context.run(); });
+    net::IoThreadGuard<net::UdpClient> client_guard{client, client_thread};
+    auto session = std::make_shared<RoomSession>(server, 60);
+    RoomHooks hooks = session->get_hooks();
+    Registry room(true);
+    Registry r(true);
+    ClientSession client_session(client);
+
+    room.setup(false);
+    r.setup(false);
+    for (std::uint32_t tick = 0; tick < TEST_TICKS; tick++) {
+        Timestep &timestep = room.get_timestep();
+
+        client_session.tick(r, net::InputMessage{tick, 0, {}});
+        r.run_systems();
+        client_session.flush();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        server.poll([&session](net::Packet const &packet) { session->push(packet); });
+        // a tick of the room, as its RoomManager worker runs it
+        timestep.accumulate(timestep.get_delta_time());
+        while (timestep.consume_tick()) {
+            hooks.before_tick(room);
+            room.run_systems();
+            hooks.after_tick(room);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        client_session.receive(r);
+
+        Entity const *player = client_session.get_player();
+
+        if (player && r.get_components<Component::Predicted>().doesContain(*player)) {
+            return;
+        }
+    }
+    std::cerr << "no player was spawned for the client in " << TEST_TICKS << " ticks" << std::endl;
+    ++FAILURES;
+}
+
+int main()
+{
+    test_join();
+    std::cout << "join: " << ((FAILURES == 0) ? "passed" : "FAILED") << std::endl;
+    return (FAILURES == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
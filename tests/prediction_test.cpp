@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include "net_prediction.h"
+#include "net_replication.h"
+
+/**
+ * @brief The ticks between an input predicted by the client and
+ * the snapshot of the server applying it.
+ *
+ */
+#define TEST_LATENCY 5
+#define TEST_TICKS 300
+
+static int FAILURES = 0;
+
+/**
+ * @brief Right for 20 ticks, then up and left every third tick
+ * for 20 ticks, and so on.
+ *
+ */
+static net::InputMessage make_input(std::uint32_t tick)
+{
+    net::InputMessage input{tick, 0, {}};
+
+    if ((tick / 20) % 2 == 0) {
+        input.keys[input.key_count++] = KEY_RIGHT;
+    } else if (tick % 3 == 0) {
+        input.keys[input.key_count++] = KEY_UP;
+        input.keys[input.key_count++] = KEY_LEFT;
+    }
+    return input;
+}
+
+static Component::Transform const &transform_of(Registry &r, Entity const &e)
+{
+    return r.get_components<Component::Transform>().component_at(e);
+}
+
+/**
+ * @brief Simulate a server applying the inputs TEST_LATENCY ticks
+ * late and a client predicting them: the client systems must not
+ * move the predicted player, and the replayed player must land
+ * where it was predicted.
+ *
+ */
+static void test_prediction()
+{
+    Registry server(true);
+    Registry client(true);
+
+    server.setup(false);
+    client.setup(false);
+
+    Prefab::Player player(server, Component::Transform{.position = Vec2(100.0f, 150.0f), .rotation = 0.0f, .scale = Vec2(3.0f, 3.0f)}, Component::RigidBody{.mass = 1.0f, .velocity = Vec2(0.0f, 0.0f), .acceleration = Vec2(0.0f, 0.0f)});
+    std::uint64_t handle = player.entity.get_handle();
+    net::SnapshotApplier applier;
+    net::Prediction prediction;
+    net::Snapshot snapshot;
+    std::deque<net::InputMessage> in_flight;
+    std::uint32_t input_tick = net::K_NO_INPUT;
+    float worst = 0.0f;
+
+    applier.set_predicted(handle);
+    for (std::uint32_t tick = 0; tick < TEST_TICKS; tick++) {
+        Entity const *local = applier.find(handle);
+
+        if (local) {
+            net::InputMessage input = make_input(tick);
+
+            prediction.predict(client, *local, input);
+            in_flight.push_back(input);
+            Vec2 predicted = transform_of(client, *local).position;
+
+            client.run_systems();
+            if (transform_of(client, *local).position != predicted) {
+                std::cerr << "tick " << tick << ": the client systems moved the predicted player" << std::endl;
+                ++FAILURES;
+                return;
+            }
+        } else {
+            client.run_systems();
+        }
+        if (in_flight.size() > TEST_LATENCY) {
+            net::apply_input(server, player.entity, in_flight.front());
+            input_tick = in_flight.front().tick;
+            in_flight.pop_front();
+        }
+        server.run_systems();
+        net::capture_snapshot(server, tick, snapshot);
+        snapshot.input_tick = input_tick;
+        applier.apply(client, snapshot);
+        local = applier.find(handle);
+        if (!local || !client.get_components<Component::Predicted>().doesContain(*local)) {
+            std::cerr << "tick " << tick << ": the player isn't tagged Predicted" << std::endl;
+            ++FAILURES;
+            return;
+        }
+        worst = std::max(worst, prediction.reconcile(client, *local, snapshot, handle));
+    }
+    if (worst > 0.0f || prediction.get_pending_count() != TEST_LATENCY) {
+        std::cerr << "mispredicted by " << worst << ", " << prediction.get_pending_count()
+                  << " inputs pending" << std::endl;
+        ++FAILURES;
+    }
+}
+
+int main()
+{
+    test_prediction();
+    std::cout << "prediction: " << ((FAILURES == 0) ? "passed" : "FAILED") << std::endl;
+    return (FAILURES == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}